@@ -0,0 +1,32 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "Activation.h"
+
+using namespace std;
+
+bool activationLayer::get_spatial_window(spatial_window& window) const
+{
+    window = spatial_window();
+    return true;
+}
+
+void activationLayer::forward(const Tensor& input, Tensor& output)
+{
+    output.shape = input.shape;
+    output.layout = input.layout;
+    output.data.resize(input.size());
+    for (int i = 0; i < input.size(); i++)
+    {
+        output.data[i] = activation(input.data[i]);
+    }
+}
+
+void activationLayer::forward_inplace(Tensor& tensor)
+{
+    for (float& v : tensor.data)
+    {
+        v = activation(v);
+    }
+}
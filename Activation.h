@@ -0,0 +1,74 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef ACTIVATION_H
+#define ACTIVATION_H
+
+#include "layer.h"
+#include "Tensor.h"
+#include "FastMath.h"
+#include <algorithm>
+#include <cstddef>
+
+using namespace std;
+
+enum class ActivationType
+{
+    Identity,
+    ReLU,
+    ReLU6,
+    LeakyReLU,
+    SiLU,
+    Clamp
+};
+
+// 逐元素激活。既可作为 Conv / fc_layer 的 epilogue，在累加结果写回前直接作用于寄存器中的值，
+// 也可由 activationLayer 单独执行
+struct Activation
+{
+    ActivationType type = ActivationType::Identity;
+    float alpha = 0.01f;            // LeakyReLU 负半轴的斜率
+    float lo = 0.0f, hi = 6.0f;     // Clamp 的区间
+
+    static Activation relu() { return {ActivationType::ReLU}; }
+    static Activation relu6() { return {ActivationType::ReLU6}; }
+    static Activation leaky_relu(float slope) { return {ActivationType::LeakyReLU, slope}; }
+    static Activation silu() { return {ActivationType::SiLU}; }
+    static Activation clamp(float m_lo, float m_hi) { return {ActivationType::Clamp, 0.0f, m_lo, m_hi}; }
+
+    bool is_identity() const { return type == ActivationType::Identity; }
+
+    float operator()(float x) const
+    {
+        switch (type)
+        {
+        case ActivationType::ReLU: return max(0.0f, x);
+        case ActivationType::ReLU6: return min(max(0.0f, x), 6.0f);
+        case ActivationType::LeakyReLU: return x > 0.0f ? x : alpha * x;
+        case ActivationType::SiLU: return x / (1.0f + fast_math::exp(-x));
+        case ActivationType::Clamp: return min(max(lo, x), hi);
+        default: return x;
+        }
+    }
+};
+
+// 单独的激活层；紧跟在 Conv 或 fc_layer 之后加入 CNN 时会被并入前一层的 epilogue
+class activationLayer : public layer
+{
+private:
+    Activation activation;
+
+public:
+    explicit activationLayer(const Activation& m_activation) : activation(m_activation) {}
+    const Activation& get_activation() const { return activation; }
+    void forward(const Tensor& input, Tensor& output) override;
+    bool supports_inplace() const override { return true; }
+    void forward_inplace(Tensor& tensor) override;
+    std::vector<int> get_output_shape(const std::vector<int>& input_shape) const override { return input_shape; }
+    // 逐元素层：1x1 窗口、步长 1
+    bool get_spatial_window(spatial_window& window) const override;
+    ~activationLayer() override = default;
+};
+
+#endif //ACTIVATION_H
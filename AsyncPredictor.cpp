@@ -0,0 +1,151 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "AsyncPredictor.h"
+#include <algorithm>
+#include <memory>
+
+using namespace std;
+
+void Log2Histogram::add(double value)
+{
+    size_t bucket = 0;
+    while (value >= 1.0 && bucket + 1 < buckets.size())
+    {
+        value /= 2.0;
+        bucket++;
+    }
+    buckets[bucket]++;
+}
+
+void Log2Histogram::print(ostream& os, const char* unit) const
+{
+    size_t last = buckets.size();
+    while (last > 0 && buckets[last - 1] == 0) last--;
+    for (size_t i = 0; i < last; i++)
+    {
+        double low = i == 0 ? 0.0 : static_cast<double>(uint64_t(1) << (i - 1));
+        os << "  [" << low << ", ";
+        if (i + 1 < buckets.size()) os << static_cast<double>(uint64_t(1) << i);
+        else os << "inf";
+        os << ") " << unit << ": " << buckets[i] << "\n";
+    }
+}
+
+void AsyncPredictorStats::print(ostream& os) const
+{
+    os << "async: " << submitted << " submitted, " << completed << " completed, " << shed << " shed (expired), queue depth "
+       << queue_depth << " (max " << max_queue_depth << ")\n";
+    os << "queue depth at submit:\n";
+    depth.print(os, "requests");
+    os << "wait time:\n";
+    wait_ms.print(os, "ms");
+    os.flush();
+}
+
+AsyncPredictor::AsyncPredictor(CNN& m_cnn, size_t worker_count) : cnn(m_cnn)
+{
+    if (worker_count == 0)
+    {
+        throw invalid_argument("AsyncPredictor: worker count must be greater than zero");
+    }
+    for (size_t i = 0; i < worker_count; i++)
+    {
+        workers.emplace_back(&AsyncPredictor::worker_loop, this);
+    }
+}
+
+future<Tensor> AsyncPredictor::predict_async(Tensor input, clock::time_point deadline)
+{
+    auto promise_ptr = make_shared<promise<Tensor>>();
+    future<Tensor> result = promise_ptr->get_future();
+    predict_async(std::move(input), deadline, [promise_ptr](const Tensor* output, exception_ptr error) {
+        if (error) promise_ptr->set_exception(error);
+        else promise_ptr->set_value(*output);
+    });
+    return result;
+}
+
+void AsyncPredictor::predict_async(Tensor input, clock::time_point deadline, callback done)
+{
+    {
+        lock_guard<mutex> lock(mtx);
+        if (stopping)
+        {
+            throw runtime_error("AsyncPredictor: submit after shutdown");
+        }
+        Request request;
+        request.deadline = deadline;
+        request.submitted = clock::now();
+        request.sequence = counters.submitted++;
+        request.input = std::move(input);
+        request.done = std::move(done);
+
+        counters.depth.add(static_cast<double>(requests.size()));
+        requests.push(std::move(request));
+        counters.queue_depth = requests.size();
+        counters.max_queue_depth = max(counters.max_queue_depth, requests.size());
+    }
+    cv.notify_one();
+}
+
+AsyncPredictorStats AsyncPredictor::stats() const
+{
+    lock_guard<mutex> lock(mtx);
+    return counters;
+}
+
+void AsyncPredictor::worker_loop()
+{
+    while (true)
+    {
+        Request request;
+        {
+            unique_lock<mutex> lock(mtx);
+            cv.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (requests.empty()) return;
+
+            // priority_queue::top 只给出 const 引用，移出后再弹出
+            request = std::move(const_cast<Request&>(requests.top()));
+            requests.pop();
+            counters.queue_depth = requests.size();
+
+            auto now = clock::now();
+            counters.wait_ms.add(chrono::duration<double, milli>(now - request.submitted).count());
+            if (now > request.deadline)
+            {
+                counters.shed++;
+                lock.unlock();
+                if (request.done) request.done(nullptr, make_exception_ptr(deadline_exceeded()));
+                continue;
+            }
+        }
+
+        Tensor output;
+        exception_ptr error;
+        try
+        {
+            output = cnn.predict(request.input);
+        }
+        catch (...)
+        {
+            error = current_exception();
+        }
+        {
+            lock_guard<mutex> lock(mtx);
+            counters.completed++;
+        }
+        if (request.done) request.done(error ? nullptr : &output, error);
+    }
+}
+
+AsyncPredictor::~AsyncPredictor()
+{
+    {
+        lock_guard<mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& worker : workers) worker.join();
+}
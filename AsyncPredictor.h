@@ -0,0 +1,103 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef ASYNC_PREDICTOR_H
+#define ASYNC_PREDICTOR_H
+
+#include "CNN.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <ostream>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// 请求在开始执行前已超过截止时间，被执行器丢弃
+class deadline_exceeded : public runtime_error
+{
+public:
+    deadline_exceeded() : runtime_error("AsyncPredictor: request expired before it was scheduled") {}
+};
+
+// 以 2 的幂划分桶的直方图：桶 0 为 [0, 1)，桶 i 为 [2^(i-1), 2^i)，最后一个桶收纳更大的值
+struct Log2Histogram
+{
+    vector<uint64_t> buckets = vector<uint64_t>(16, 0);
+
+    void add(double value);
+    void print(ostream& os, const char* unit) const;
+};
+
+struct AsyncPredictorStats
+{
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t shed = 0;            // 过期被丢弃的请求
+    size_t queue_depth = 0;       // 当前排队数
+    size_t max_queue_depth = 0;
+    Log2Histogram depth;          // 每次提交时看到的排队数
+    Log2Histogram wait_ms;        // 从提交到开始执行的等待时间 (ms)
+
+    void print(ostream& os) const;
+};
+
+// 异步推理执行器：请求进入按截止时间排序的队列 (最早截止优先)，工作线程取出后调用 CNN::predict；
+// 取出时已过截止时间的请求直接丢弃，future 以 deadline_exceeded 结束，回调收到空指针。
+// 各层 forward 不修改自身状态，workers 大于 1 时多个请求可同时执行
+class AsyncPredictor
+{
+public:
+    using clock = chrono::steady_clock;
+    using callback = function<void(const Tensor* output, exception_ptr error)>;
+
+    explicit AsyncPredictor(CNN& m_cnn, size_t workers = 1);
+    AsyncPredictor(const AsyncPredictor&) = delete;
+    AsyncPredictor& operator=(const AsyncPredictor&) = delete;
+
+    future<Tensor> predict_async(Tensor input, clock::time_point deadline);
+    // 回调在工作线程上执行，不应长时间阻塞
+    void predict_async(Tensor input, clock::time_point deadline, callback done);
+
+    AsyncPredictorStats stats() const;
+
+    // 执行完已排队的请求 (过期的照常丢弃) 后结束工作线程
+    ~AsyncPredictor();
+
+private:
+    struct Request
+    {
+        clock::time_point deadline;
+        clock::time_point submitted;
+        uint64_t sequence = 0;      // 截止时间相同时先提交的先执行
+        Tensor input;
+        callback done;
+    };
+
+    struct LaterDeadline
+    {
+        bool operator()(const Request& a, const Request& b) const
+        {
+            return a.deadline != b.deadline ? a.deadline > b.deadline : a.sequence > b.sequence;
+        }
+    };
+
+    CNN& cnn;
+    priority_queue<Request, vector<Request>, LaterDeadline> requests;
+    vector<thread> workers;
+    mutable mutex mtx;
+    condition_variable cv;
+    bool stopping = false;
+    AsyncPredictorStats counters;
+
+    void worker_loop();
+};
+
+#endif //ASYNC_PREDICTOR_H
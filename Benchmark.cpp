@@ -0,0 +1,428 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "Benchmark.h"
+#include "InferenceTasks.h"
+#include "PipelineExecutor.h"
+#include "Preprocess.h"
+#include "ResultCache.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <system_error>
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+    using bench_clock = chrono::steady_clock;
+
+    double elapsed_ms(bench_clock::time_point start)
+    {
+        return chrono::duration<double, milli>(bench_clock::now() - start).count();
+    }
+}
+
+void bench_decode(const vector<string>& paths, int target_h, int target_w, ostream& os)
+{
+    double full_ms = 0.0, reduced_ms = 0.0;
+    int counted = 0;
+    int scale_histogram[9] = {0};
+    Tensor tensor;
+
+    for (const string& path : paths)
+    {
+        // 两种方式都从内存中的文件字节解码，排除磁盘读取的差异
+        ifstream file(path, ios::binary);
+        vector<uchar> bytes((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+        int src_h = 0, src_w = 0;
+        if (!read_jpeg_size(bytes, src_h, src_w)) continue;
+
+        int scale = choose_decode_scale(src_h, src_w, target_h, target_w);
+
+        auto start = bench_clock::now();
+        image_to_tensor(cv::imdecode(bytes, cv::IMREAD_COLOR), target_h, target_w, tensor);
+        full_ms += elapsed_ms(start);
+
+        start = bench_clock::now();
+        image_to_tensor(decode_image(bytes, target_h, target_w), target_h, target_w, tensor);
+        reduced_ms += elapsed_ms(start);
+
+        scale_histogram[scale]++;
+        counted++;
+    }
+
+    os << "decode benchmark: " << counted << " JPEG files, target " << target_h << "x" << target_w << "\n";
+    if (counted == 0) return;
+    os << "  full decode + resize:    " << full_ms / counted << " ms/img\n";
+    os << "  reduced decode + resize: " << reduced_ms / counted << " ms/img\n";
+    os << "  speedup: " << (reduced_ms > 0 ? full_ms / reduced_ms : 0.0) << "x"
+       << " (scale 1/2/4/8: " << scale_histogram[1] << "/" << scale_histogram[2] << "/"
+       << scale_histogram[4] << "/" << scale_histogram[8] << ")" << endl;
+}
+
+void bench_file_cache(CNN& cnn, const vector<string>& paths, int rounds, ostream& os)
+{
+    if (paths.empty() || rounds <= 0)
+    {
+        os << "file cache benchmark: nothing to run" << endl;
+        return;
+    }
+
+    // 不经缓存：每次都读文件、降分辨率解码、预处理、推理
+    vector<Tensor> expected(paths.size());
+    Tensor input;
+    auto start = bench_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            image_to_tensor(read_image(paths[i], 128, 128), 128, 128, input);
+            expected[i] = cnn.predict(input);
+        }
+    }
+    double plain_ms = elapsed_ms(start);
+
+    // 按文件字节缓存：第一轮全部未命中，之后各轮只剩读文件与哈希
+    CachedPredictor predictor(cnn, paths.size());
+    size_t mismatched = 0;
+    start = bench_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            if (predictor.predict_file(paths[i], 128, 128).data != expected[i].data) mismatched++;
+        }
+    }
+    double cached_ms = elapsed_ms(start);
+
+    double images = static_cast<double>(paths.size()) * rounds;
+    os << "file cache benchmark: " << paths.size() << " files x " << rounds << " rounds\n";
+    os << "  uncached:      " << plain_ms / images << " ms/img\n";
+    os << "  predict_file:  " << cached_ms / images << " ms/img, mismatched " << mismatched << "\n";
+    predictor.stats().print(os);
+}
+
+void bench_cache(CNN& cnn, const TensorCacheReader& cache, int repeats, ostream& os)
+{
+    size_t count = cache.size();
+    if (count == 0 || repeats <= 0)
+    {
+        os << "cache benchmark: nothing to run" << endl;
+        return;
+    }
+
+    // 先跑一轮预热，让映射页进入页缓存
+    for (size_t i = 0; i < count; i++) cnn.predict(cache.view(i));
+
+    auto start = bench_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            cnn.predict(cache.view(i));
+        }
+    }
+    double total_ms = elapsed_ms(start);
+    double images = static_cast<double>(count) * repeats;
+    os << "cache benchmark: " << count << " tensors x " << repeats << " rounds, "
+       << total_ms / images << " ms/img, " << images * 1000.0 / total_ms << " img/s" << endl;
+}
+
+void bench_topk(CNN& cnn, const TensorCacheReader& cache, int repeats, ostream& os)
+{
+    size_t count = cache.size();
+    if (count == 0 || repeats <= 0)
+    {
+        os << "topk benchmark: nothing to run" << endl;
+        return;
+    }
+
+    // 端到端：卷积部分相同，差别只在输出头
+    auto start = bench_clock::now();
+    for (size_t i = 0; i < count; i++) cnn.predict(cache.view(i));
+    double predict_ms = elapsed_ms(start);
+    start = bench_clock::now();
+    for (size_t i = 0; i < count; i++) cnn.predict_binary(cache.view(i));
+    double binary_ms = elapsed_ms(start);
+
+    // 只测输出头：logits 先算好，重复 repeats 轮放大差别
+    vector<Tensor> logits;
+    for (size_t i = 0; i < count; i++) logits.push_back(cnn.predict_logits(cache.view(i)));
+    softMax head;
+    size_t checksum = 0;
+    start = bench_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        for (Tensor& z : logits)
+        {
+            Tensor probs;
+            head.forward(z, probs);
+            checksum += max_element(probs.data.begin(), probs.data.end()) - probs.data.begin();
+        }
+    }
+    double softmax_ms = elapsed_ms(start);
+    start = bench_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        for (Tensor& z : logits)
+        {
+            checksum += max_element(z.data.begin(), z.data.end()) - z.data.begin();
+        }
+    }
+    double argmax_ms = elapsed_ms(start);
+
+    double heads = static_cast<double>(count) * repeats;
+    os << "topk benchmark: " << count << " tensors" << endl
+       << "  end to end: predict " << predict_ms / count << " ms/img, predict_binary " << binary_ms / count << " ms/img" << endl
+       << "  output head: softmax+argmax " << softmax_ms * 1000.0 / heads << " us/img, argmax on logits "
+       << argmax_ms * 1000.0 / heads << " us/img (checksum " << checksum << ")" << endl;
+}
+
+void bench_layout(CNN& cnn, const TensorCacheReader& cache, int repeats, ostream& os)
+{
+    size_t count = cache.size();
+    if (count == 0 || repeats <= 0)
+    {
+        os << "layout benchmark: nothing to run" << endl;
+        return;
+    }
+
+    // HWC 的输入直接按通道在最后的排布给出，对应预处理不做转置的情形
+    vector<Tensor> inputs, hwc_inputs;
+    for (size_t i = 0; i < count; i++)
+    {
+        inputs.push_back(cache.view(i).to_tensor());
+        hwc_inputs.push_back(to_channels_last(inputs.back()));
+    }
+
+    TensorLayout original = cnn.get_layout();
+    auto run = [&](TensorLayout layout, vector<Tensor>& batch, vector<Tensor>& outputs) {
+        cnn.set_layout(layout);
+        outputs.clear();
+        for (Tensor& input : batch) outputs.push_back(cnn.predict(input));
+        auto start = bench_clock::now();
+        for (int r = 0; r < repeats; r++)
+        {
+            for (Tensor& input : batch) cnn.predict(input);
+        }
+        return elapsed_ms(start) / (static_cast<double>(count) * repeats);
+    };
+
+    vector<Tensor> planar_out, blocked_out, hwc_out;
+    double planar_ms = run(TensorLayout::CHW, inputs, planar_out);
+    double blocked_ms = run(TensorLayout::CHWc, inputs, blocked_out);
+    double hwc_ms = run(TensorLayout::HWC, hwc_inputs, hwc_out);
+    cnn.set_layout(original);
+
+    size_t mismatches = 0;
+    float hwc_diff = 0.0f;
+    for (size_t i = 0; i < count; i++)
+    {
+        mismatches += planar_out[i].data != blocked_out[i].data;
+        for (size_t j = 0; j < planar_out[i].data.size(); j++) hwc_diff = max(hwc_diff, fabs(planar_out[i].data[j] - hwc_out[i].data[j]));
+    }
+    os << "layout benchmark: " << count << " tensors x " << repeats << " rounds, channel block " << channel_block << endl
+       << "  CHW  " << planar_ms << " ms/img" << endl
+       << "  CHWc " << blocked_ms << " ms/img (" << planar_ms / blocked_ms << "x), "
+       << mismatches << " outputs differ" << endl
+       << "  HWC  " << hwc_ms << " ms/img (" << planar_ms / hwc_ms << "x), max |diff| " << hwc_diff << endl;
+}
+
+void bench_pipeline(CNN& cnn, const TensorCacheReader& cache, int stages, ostream& os)
+{
+    size_t count = cache.size();
+    if (count == 0)
+    {
+        os << "pipeline benchmark: nothing to run" << endl;
+        return;
+    }
+
+    vector<Tensor> inputs;
+    for (size_t i = 0; i < count; i++) inputs.push_back(cache.view(i).to_tensor());
+
+    auto start = bench_clock::now();
+    for (Tensor& input : inputs) cnn.predict(input);
+    double serial_ms = elapsed_ms(start);
+
+    PipelineConfig config;
+    config.stages = stages;
+    PipelineExecutor executor(cnn, inputs[0], config);
+    PipelineStats stats = executor.run(inputs, nullptr);
+
+    os << "serial: " << count << " items in " << serial_ms << " ms, " << count * 1000.0 / serial_ms << " items/s\n";
+    stats.print(os);
+    os << "speedup: " << (stats.wall_ms > 0 ? serial_ms / stats.wall_ms : 0.0) << "x" << endl;
+}
+
+void bench_coroutines(CNN& cnn, const vector<string>& paths, size_t requests, ostream& os)
+{
+    if (paths.empty() || requests == 0)
+    {
+        os << "coroutine benchmark: nothing to run" << endl;
+        return;
+    }
+
+    // 协程：当前线程一次性发起全部请求，只在最后等待计数归零
+    ThreadPool& pool = ThreadPool::shared();
+    atomic<size_t> remaining{requests};
+    atomic<size_t> failed{0};
+    mutex done_mtx;
+    condition_variable done_cv;
+
+    auto start = bench_clock::now();
+    for (size_t i = 0; i < requests; i++)
+    {
+        [](CNN& m_cnn, string path, ThreadPool& m_pool, atomic<size_t>& m_remaining, atomic<size_t>& m_failed,
+           mutex& m_mtx, condition_variable& m_cv) -> Detached {
+            try
+            {
+                co_await classify(m_cnn, std::move(path), m_pool);
+            }
+            catch (...)
+            {
+                m_failed++;
+            }
+            // 计数与通知都在锁内：等待方只能在这里解锁之后看到计数归零并返回 (随后销毁 m_mtx / m_cv)
+            lock_guard<mutex> lock(m_mtx);
+            if (--m_remaining == 0) m_cv.notify_all();
+        }(cnn, paths[i % paths.size()], pool, remaining, failed, done_mtx, done_cv);
+    }
+    {
+        unique_lock<mutex> lock(done_mtx);
+        done_cv.wait(lock, [&remaining] { return remaining == 0; });
+    }
+    double coroutine_ms = elapsed_ms(start);
+
+    // 对照：每个请求一个线程，阻塞执行全部阶段
+    atomic<size_t> thread_failed{0};
+    vector<thread> threads;
+    threads.reserve(requests);
+    size_t spawned = 0;
+    start = bench_clock::now();
+    for (size_t i = 0; i < requests; i++)
+    {
+        try
+        {
+            threads.emplace_back([&cnn, &thread_failed, path = paths[i % paths.size()]] {
+                try
+                {
+                    Tensor input;
+                    image_to_tensor(read_image(path, 128, 128), 128, 128, input);
+                    cnn.predict(input);
+                }
+                catch (...)
+                {
+                    thread_failed++;
+                }
+            });
+            spawned++;
+        }
+        catch (const system_error&)
+        {
+            break;  // 达到系统线程数上限
+        }
+    }
+    for (auto& worker : threads) worker.join();
+    double thread_ms = elapsed_ms(start);
+
+    os << "coroutine benchmark: " << requests << " concurrent requests\n";
+    os << "  coroutines:         " << coroutine_ms << " ms, " << requests * 1000.0 / coroutine_ms << " req/s, "
+       << pool.size() << " pool threads, failed " << failed.load() << "\n";
+    os << "  thread-per-request: " << thread_ms << " ms, " << spawned * 1000.0 / thread_ms << " req/s, "
+       << spawned << " threads";
+    if (spawned < requests) os << " (thread creation failed after " << spawned << ")";
+    os << ", failed " << thread_failed.load() << endl;
+}
+
+void bench_fc(int in_features, int out_features, int batch, int repeats, ostream& os)
+{
+    if (in_features <= 0 || out_features <= 0 || batch <= 0 || repeats <= 0)
+    {
+        os << "fc benchmark: nothing to run" << endl;
+        return;
+    }
+
+    mt19937 rng(7);
+    uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    vector<float> weights(static_cast<size_t>(in_features) * out_features), biases(out_features);
+    for (float& v : weights) v = dist(rng);
+    for (float& v : biases) v = dist(rng);
+    fc_layer fc(weights.data(), in_features, out_features, biases.data(), out_features);
+
+    Tensor batch_input({batch, in_features});
+    for (float& v : batch_input.data) v = dist(rng);
+    vector<Tensor> samples;
+    for (int n = 0; n < batch; n++)
+    {
+        Tensor sample({in_features});
+        copy(batch_input.data.begin() + static_cast<size_t>(n) * in_features,
+             batch_input.data.begin() + static_cast<size_t>(n + 1) * in_features, sample.data.begin());
+        samples.push_back(std::move(sample));
+    }
+
+    // 参考实现：每个输出一条串行的加法链
+    vector<float> reference(out_features);
+    auto start = bench_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        for (int o = 0; o < out_features; o++)
+        {
+            float sum = 0.0f;
+            for (int i = 0; i < in_features; i++) sum += samples[0].data[i] * weights[static_cast<size_t>(o) * in_features + i];
+            reference[o] = sum + biases[o];
+        }
+    }
+    double reference_ms = elapsed_ms(start);
+
+    Tensor output;
+    start = bench_clock::now();
+    for (int r = 0; r < repeats; r++) fc.forward(samples[0], output);
+    double gemv_ms = elapsed_ms(start);
+    double max_diff = 0.0;
+    for (int o = 0; o < out_features; o++) max_diff = max(max_diff, static_cast<double>(fabs(output.data[o] - reference[o])));
+
+    fc.set_thread_pool(&ThreadPool::shared());
+    start = bench_clock::now();
+    for (int r = 0; r < repeats; r++) fc.forward(samples[0], output);
+    double threaded_ms = elapsed_ms(start);
+    fc.set_thread_pool(nullptr);
+
+    start = bench_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        for (Tensor& sample : samples) fc.forward(sample, output);
+    }
+    double single_ms = elapsed_ms(start);
+    Tensor batch_output;
+    start = bench_clock::now();
+    for (int r = 0; r < repeats; r++) fc.forward(batch_input, batch_output);
+    double gemm_ms = elapsed_ms(start);
+
+    // 成批结果应与逐个计算逐位一致
+    size_t mismatches = 0;
+    for (int n = 0; n < batch; n++)
+    {
+        fc.forward(samples[n], output);
+        for (int o = 0; o < out_features; o++)
+        {
+            mismatches += output.data[o] != batch_output.data[static_cast<size_t>(n) * out_features + o];
+        }
+    }
+
+    double per_sample = 1000.0 / repeats;
+    os << "fc benchmark: " << in_features << " -> " << out_features << ", batch " << batch << endl
+       << "  single sample: serial reference " << reference_ms * per_sample << " us, GEMV " << gemv_ms * per_sample
+       << " us, GEMV on " << ThreadPool::shared().size() << " threads " << threaded_ms * per_sample
+       << " us (max diff " << max_diff << ")" << endl
+       << "  batch: GEMV per sample " << single_ms * per_sample / batch << " us, GEMM per sample "
+       << gemm_ms * per_sample / batch << " us (" << mismatches << " mismatches)" << endl;
+}
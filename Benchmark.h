@@ -0,0 +1,45 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "CNN.h"
+#include "TensorCache.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// 解码耗时对比：全分辨率解码+缩放 与 按目标尺寸降分辨率解码+缩放
+void bench_decode(const vector<string>& paths, int target_h, int target_w, ostream& os);
+
+// 同一组文件重复 rounds 轮：每次读文件+解码+预处理+推理 与 CachedPredictor::predict_file (按文件字节缓存结果)
+// 的每张耗时对比，并核对两者输出一致
+void bench_file_cache(CNN& cnn, const vector<string>& paths, int rounds, ostream& os);
+
+// 直接在映射的缓存文件上重复推理 repeats 轮，不含任何解码与预处理
+void bench_cache(CNN& cnn, const TensorCacheReader& cache, int repeats, ostream& os);
+
+// 只需要类别时的输出头开销：softMax + 取最大 与 直接在 logits 上 predict_topk / predict_binary 的对比，
+// 另给出整条 predict 与 predict_binary 的端到端耗时
+void bench_topk(CNN& cnn, const TensorCacheReader& cache, int repeats, ostream& os);
+
+// 同一批张量分别以 CHW、CHWc 与 HWC (CNN::set_layout，HWC 时输入也为 HWC) 推理 repeats 轮，
+// 比较耗时与输出差异；结束后恢复原布局
+void bench_layout(CNN& cnn, const TensorCacheReader& cache, int repeats, ostream& os);
+
+// 缓存中的张量逐个串行 predict 与经层流水线 (PipelineExecutor) 处理的吞吐对比，stages 为 0 时自动选择级数
+void bench_pipeline(CNN& cnn, const TensorCacheReader& cache, int stages, ostream& os);
+
+// requests 个分类请求 (循环使用 paths) 同时发起：协程版本在共享线程池上挂起/恢复，
+// 对照版本为每个请求创建一个线程，比较总耗时与使用的线程数
+void bench_coroutines(CNN& cnn, const vector<string>& paths, size_t requests, ostream& os);
+
+// 随机权重的 in_features x out_features 全连接层：逐元素串行累加的参考实现、GEMV (单线程 / 共享线程池)
+// 与 batch 个样本逐个 GEMV / 整批 GEMM 的每样本耗时对比，重复 repeats 轮
+void bench_fc(int in_features, int out_features, int batch, int repeats, ostream& os);
+
+#endif //BENCHMARK_H
@@ -0,0 +1,105 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+using namespace std;
+
+// 容量有限的阻塞队列，用于流水线各阶段之间的交接。
+// close() 之后 push 失败，pop 在取完剩余元素后返回 false。
+template <typename T>
+class BoundedQueue
+{
+private:
+    deque<T> items;
+    size_t capacity;
+    bool closed = false;
+    mutable mutex mtx;
+    condition_variable not_empty;
+    condition_variable not_full;
+
+public:
+    explicit BoundedQueue(size_t m_capacity) : capacity(m_capacity > 0 ? m_capacity : 1) {}
+
+    // 队列满时阻塞等待
+    bool push(T item)
+    {
+        unique_lock<mutex> lock(mtx);
+        not_full.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed) return false;
+        items.push_back(std::move(item));
+        lock.unlock();
+        not_empty.notify_one();
+        return true;
+    }
+
+    // 队列满时不等待，直接返回 false
+    bool try_push(T item)
+    {
+        unique_lock<mutex> lock(mtx);
+        if (closed || items.size() >= capacity) return false;
+        items.push_back(std::move(item));
+        lock.unlock();
+        not_empty.notify_one();
+        return true;
+    }
+
+    // 队列满时丢弃最旧的元素再放入，保证消费者总拿到最新的数据；dropped 表示是否丢弃了元素
+    bool push_drop_oldest(T item, bool& dropped)
+    {
+        unique_lock<mutex> lock(mtx);
+        dropped = false;
+        if (closed) return false;
+        if (items.size() >= capacity)
+        {
+            items.pop_front();
+            dropped = true;
+        }
+        items.push_back(std::move(item));
+        lock.unlock();
+        not_empty.notify_one();
+        return true;
+    }
+
+    bool pop(T& item)
+    {
+        unique_lock<mutex> lock(mtx);
+        not_empty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        lock.unlock();
+        not_full.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        {
+            lock_guard<mutex> lock(mtx);
+            closed = true;
+        }
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+    bool is_closed() const
+    {
+        lock_guard<mutex> lock(mtx);
+        return closed;
+    }
+
+    size_t size() const
+    {
+        lock_guard<mutex> lock(mtx);
+        return items.size();
+    }
+};
+
+#endif //BOUNDED_QUEUE_H
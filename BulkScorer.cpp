@@ -0,0 +1,268 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "BulkScorer.h"
+#include "BoundedQueue.h"
+#include "Preprocess.h"
+#include "ResultCache.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+    using bulk_clock = chrono::steady_clock;
+
+    double elapsed_ms(bulk_clock::time_point start)
+    {
+        return chrono::duration<double, milli>(bulk_clock::now() - start).count();
+    }
+
+    // 环中的一个输入批次，Tensor 预先按网络输入尺寸分配，反复复用
+    struct InputBatch
+    {
+        vector<Tensor> inputs;
+        vector<char> loaded;
+        size_t first = 0;   // 本批次第一张图像在 paths 中的下标
+        int count = 0;
+        atomic<int> pending{0};
+    };
+
+    void write_result(ostream& out, ScoreOutputFormat format, const string& path, float p_face, float p_background)
+    {
+        if (format == ScoreOutputFormat::CSV)
+        {
+            out << path << ',' << p_face << ',' << p_background << '\n';
+            return;
+        }
+        uint32_t length = static_cast<uint32_t>(path.size());
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(path.data(), length);
+        out.write(reinterpret_cast<const char*>(&p_face), sizeof(p_face));
+        out.write(reinterpret_cast<const char*>(&p_background), sizeof(p_background));
+    }
+}
+
+void BulkScoreStats::print(ostream& os) const
+{
+    double seconds = wall_ms / 1000.0;
+    double decode_util = wall_ms > 0 ? decode_busy_ms / (wall_ms * max(1, io_threads)) : 0.0;
+    double infer_util = wall_ms > 0 ? infer_busy_ms / wall_ms : 0.0;
+
+    os << "images: " << images << " (failed " << failed << ") in " << wall_ms << " ms, "
+       << (seconds > 0 ? images / seconds : 0.0) << " img/s\n";
+    os << "decode: " << decode_busy_ms << " ms busy over " << io_threads << " threads, utilization "
+       << decode_util * 100.0 << "%, dispatcher waited " << dispatch_wait_ms << " ms for free batches\n";
+    os << "infer:  " << infer_busy_ms << " ms busy, utilization " << infer_util * 100.0
+       << "%, waited " << infer_wait_ms << " ms for ready batches\n";
+    if (cache_hits > 0) os << "cache: " << cache_hits << " duplicate images served from the result cache\n";
+    os << "bottleneck: " << (infer_util >= decode_util ? "inference" : "decode/preprocess") << endl;
+}
+
+BulkScorer::BulkScorer(CNN& m_cnn, const BulkScoreConfig& m_config) : cnn(m_cnn), config(m_config)
+{
+    if (config.io_threads <= 0 || config.batch_size <= 0 || config.ring_batches <= 0)
+    {
+        throw invalid_argument("BulkScorer: io_threads, batch_size and ring_batches must be greater than zero");
+    }
+    if (config.input_h <= 0 || config.input_w <= 0)
+    {
+        throw invalid_argument("BulkScorer: input size must be greater than zero");
+    }
+}
+
+vector<string> BulkScorer::collect_paths(const string& dir_or_list)
+{
+    namespace fs = std::filesystem;
+    vector<string> paths;
+
+    if (fs::is_directory(dir_or_list))
+    {
+        const vector<string> extensions = {".jpg", ".jpeg", ".png", ".bmp"};
+        for (const auto& entry : fs::recursive_directory_iterator(dir_or_list))
+        {
+            if (!entry.is_regular_file()) continue;
+            string ext = entry.path().extension().string();
+            transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char ch) { return static_cast<char>(tolower(ch)); });
+            if (find(extensions.begin(), extensions.end(), ext) != extensions.end())
+            {
+                paths.push_back(entry.path().string());
+            }
+        }
+        sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    ifstream list(dir_or_list);
+    if (!list)
+    {
+        throw runtime_error("BulkScorer: cannot open " + dir_or_list);
+    }
+    string line;
+    while (getline(list, line))
+    {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty()) paths.push_back(line);
+    }
+    return paths;
+}
+
+BulkScoreStats BulkScorer::run(const vector<string>& paths, ostream& out)
+{
+    BulkScoreStats stats;
+    stats.io_threads = config.io_threads;
+
+    const size_t batch_size = static_cast<size_t>(config.batch_size);
+    const size_t batch_count = (paths.size() + batch_size - 1) / batch_size;
+
+    vector<InputBatch> ring(config.ring_batches);
+    for (auto& batch : ring)
+    {
+        batch.inputs.assign(batch_size, Tensor({3, config.input_h, config.input_w}));
+        batch.loaded.assign(batch_size, 0);
+    }
+
+    // 空闲批次 -> 分发线程填充 -> 就绪批次 -> 推理线程消费 -> 归还为空闲批次
+    BoundedQueue<int> free_batches(ring.size());
+    BoundedQueue<int> ready_batches(ring.size());
+    for (int i = 0; i < static_cast<int>(ring.size()); i++)
+    {
+        free_batches.push(i);
+    }
+
+    if (config.format == ScoreOutputFormat::CSV)
+    {
+        out << "path,p_face,p_background\n";
+    }
+
+    unique_ptr<CachedPredictor> cached;
+    if (config.cache_capacity > 0) cached = make_unique<CachedPredictor>(cnn, config.cache_capacity);
+
+    atomic<long long> decode_busy_us{0};
+    double dispatch_wait_ms = 0.0;
+    auto start = bulk_clock::now();
+
+    {
+        ThreadPool io_pool(config.io_threads);
+
+        thread dispatcher([&] {
+            for (size_t b = 0; b < batch_count; b++)
+            {
+                auto wait_start = bulk_clock::now();
+                int slot;
+                if (!free_batches.pop(slot)) return;
+                dispatch_wait_ms += elapsed_ms(wait_start);
+
+                InputBatch& batch = ring[slot];
+                batch.first = b * batch_size;
+                batch.count = static_cast<int>(min(batch_size, paths.size() - batch.first));
+                batch.pending = batch.count;
+
+                for (int j = 0; j < batch.count; j++)
+                {
+                    io_pool.submit([&, slot, j] {
+                        InputBatch& target = ring[slot];
+                        auto decode_start = bulk_clock::now();
+                        try
+                        {
+                            cv::Mat image = read_image(paths[target.first + j], config.input_h, config.input_w);
+                            image_to_tensor(image, config.input_h, config.input_w, target.inputs[j]);
+                            target.loaded[j] = 1;
+                        }
+                        catch (const exception& e)
+                        {
+                            cerr << e.what() << endl;
+                            target.loaded[j] = 0;
+                        }
+                        decode_busy_us += chrono::duration_cast<chrono::microseconds>(bulk_clock::now() - decode_start).count();
+                        if (--target.pending == 0)
+                        {
+                            ready_batches.push(slot);
+                        }
+                    });
+                }
+            }
+        });
+
+        try
+        {
+            for (size_t b = 0; b < batch_count; b++)
+            {
+                auto wait_start = bulk_clock::now();
+                int slot;
+                if (!ready_batches.pop(slot)) break;
+                stats.infer_wait_ms += elapsed_ms(wait_start);
+
+                auto infer_start = bulk_clock::now();
+                InputBatch& batch = ring[slot];
+                if (cached)
+                {
+                    for (int j = 0; j < batch.count; j++)
+                    {
+                        const string& path = paths[batch.first + j];
+                        if (!batch.loaded[j])
+                        {
+                            stats.failed++;
+                            continue;
+                        }
+                        Tensor result = cached->predict(batch.inputs[j]);
+                        write_result(out, config.format, path, result.data[0], result.data[1]);
+                        stats.images++;
+                    }
+                }
+                else
+                {
+                    // 解码成功的输入暂时移出环形缓冲区组成一批，全连接层整批以 GEMM 计算，算完再放回
+                    vector<Tensor> inputs;
+                    vector<int> slots;
+                    for (int j = 0; j < batch.count; j++)
+                    {
+                        if (!batch.loaded[j])
+                        {
+                            stats.failed++;
+                            continue;
+                        }
+                        slots.push_back(j);
+                        inputs.push_back(std::move(batch.inputs[j]));
+                    }
+                    vector<Tensor> results = cnn.predict_batch(inputs);
+                    for (size_t k = 0; k < slots.size(); k++)
+                    {
+                        write_result(out, config.format, paths[batch.first + slots[k]], results[k].data[0], results[k].data[1]);
+                        batch.inputs[slots[k]] = std::move(inputs[k]);
+                        stats.images++;
+                    }
+                }
+                stats.infer_busy_ms += elapsed_ms(infer_start);
+                free_batches.push(slot);
+            }
+        }
+        catch (...)
+        {
+            // 推理出错：关闭两个队列让分发线程从 pop / push 中退出，等它结束后再把异常抛给调用方
+            free_batches.close();
+            ready_batches.close();
+            dispatcher.join();
+            throw;
+        }
+
+        dispatcher.join();
+    }
+
+    out.flush();
+    stats.wall_ms = elapsed_ms(start);
+    if (cached) stats.cache_hits = cached->stats().hits;
+    stats.decode_busy_ms = decode_busy_us / 1000.0;
+    stats.dispatch_wait_ms = dispatch_wait_ms;
+    return stats;
+}
@@ -0,0 +1,65 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef BULK_SCORER_H
+#define BULK_SCORER_H
+
+#include "CNN.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+enum class ScoreOutputFormat
+{
+    CSV,    // 每行 "path,p_face,p_background"
+    Binary  // 每条记录: uint32 路径长度, 路径字节, float p_face, float p_background
+};
+
+struct BulkScoreConfig
+{
+    int io_threads = 4;       // 解码与预处理线程数
+    int batch_size = 16;      // 每个输入批次的图像数
+    int ring_batches = 4;     // 预分配的输入批次个数 (环形复用)
+    int input_h = 128;        // 网络输入尺寸
+    int input_w = 128;
+    ScoreOutputFormat format = ScoreOutputFormat::CSV;
+    size_t cache_capacity = 0;  // 按输入内容去重的结果缓存条数，0 表示不使用 (ResultCache.h)
+};
+
+// 各阶段的耗时统计，用于判断瓶颈在解码还是推理
+struct BulkScoreStats
+{
+    size_t images = 0;
+    size_t failed = 0;
+    int io_threads = 0;
+    double wall_ms = 0.0;
+    double decode_busy_ms = 0.0;   // 所有 I/O 线程解码+预处理耗时之和
+    double infer_busy_ms = 0.0;    // 推理线程执行 predict 的耗时
+    double infer_wait_ms = 0.0;    // 推理线程等待就绪批次的耗时 (解码跟不上)
+    double dispatch_wait_ms = 0.0; // 分发线程等待空闲批次的耗时 (推理跟不上)
+    size_t cache_hits = 0;         // 结果缓存命中 (重复图像) 而跳过推理的次数
+
+    void print(ostream& os) const;
+};
+
+// 批量打分流水线：I/O 线程池解码并预处理到预分配的批次环中，推理线程同时消费已就绪的批次
+class BulkScorer
+{
+private:
+    CNN& cnn;
+    BulkScoreConfig config;
+
+public:
+    BulkScorer(CNN& m_cnn, const BulkScoreConfig& m_config);
+
+    // 目录则递归收集其中的图像文件 (按路径排序)，否则视为每行一个路径的列表文件
+    static vector<string> collect_paths(const string& dir_or_list);
+
+    // 对 paths 中所有图像打分，结果流式写入 out (二进制格式时 out 需以 binary 模式打开)
+    BulkScoreStats run(const vector<string>& paths, ostream& out);
+};
+
+#endif //BULK_SCORER_H
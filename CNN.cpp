@@ -3,64 +3,289 @@
 //
 
 #include "CNN.h"
+#include "Preprocess.h"
 #include "opencv2/imgproc/types_c.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
 using namespace std;
 
-Tensor CNN::load_image_as_tensor(const char* path)
+namespace
 {
-    cv::Mat image = cv::imread(path);  // ʹô·
-    if (image.empty()) {
-        std::cerr << "޷ͼ" << path << std::endl;
-        throw std::runtime_error("Image load failed");  // Ĵ
+    // reluLayer  activationLayer Բǰһ
+    bool as_activation(const shared_ptr<layer>& m_layer, Activation& activation)
+    {
+        if (dynamic_pointer_cast<reluLayer>(m_layer))
+        {
+            activation = Activation::relu();
+            return true;
+        }
+        if (shared_ptr<activationLayer> act = dynamic_pointer_cast<activationLayer>(m_layer))
+        {
+            activation = act->get_activation();
+            return true;
+        }
+        return false;
     }
 
-    // תΪͲһ [0, 1]
-    cv::Mat floatImage;
-    image.convertTo(floatImage, CV_32F, 1.0/255.0);
+    vector<ClassScore> top_k(const Tensor& logits, int k)
+    {
+        if (k <= 0)
+        {
+            throw invalid_argument("CNN predict_topk: k must be positive");
+        }
+        vector<ClassScore> scores(logits.size());
+        for (size_t i = 0; i < scores.size(); i++) scores[i] = {static_cast<int>(i), logits.data[i]};
 
-    // ȷ
-    if (!floatImage.isContinuous()) {
-        floatImage = floatImage.clone();
+        size_t n = min(static_cast<size_t>(k), scores.size());
+        auto by_logit = [](const ClassScore& a, const ClassScore& b) { return a.logit > b.logit || (a.logit == b.logit && a.index < b.index); };
+        partial_sort(scores.begin(), scores.begin() + n, scores.end(), by_logit);
+        scores.resize(n);
+        return scores;
     }
 
-    // ֱʹ OpenCV ݳʼ vector
-    const int totalElements = floatImage.rows * floatImage.cols * floatImage.channels();
-    std::vector<float> floatArray(
-        reinterpret_cast<float*>(floatImage.data),
-        reinterpret_cast<float*>(floatImage.data) + totalElements
-    );
-    int m_size = floatArray.size();
-    vector <float> floatFinal;
-    for (int i = 0; i <= 2; i++)
+    bool binary_decision(const Tensor& logits, int positive, float threshold, float* margin)
     {
-        for (int j = i;j <= m_size - 1;j += 3)
+        if (logits.size() != 2 || (positive != 0 && positive != 1))
+        {
+            throw invalid_argument("CNN predict_binary: expects exactly two classes");
+        }
+        if (!(threshold > 0.0f && threshold < 1.0f))
         {
-            floatFinal.push_back(floatArray[j]);
+            throw invalid_argument("CNN predict_binary: threshold must be in (0, 1)");
         }
+        float diff = logits.data[positive] - logits.data[1 - positive];
+        if (margin) *margin = diff;
+        return diff > std::log(threshold / (1.0f - threshold));
+    }
+}
+
+Tensor CNN::load_image_as_tensor(const char* path)
+{
+    cv::Mat image = cv::imread(path);  // ʹô·
+    if (image.empty()) {
+        std::cerr << "޷ͼ" << path << std::endl;
+        throw std::runtime_error("Image load failed");  // Ĵ
     }
+
+    // һ [0, 1]CHW ʱ HWC תΪ CHW (ֹͬһԤ·)HWC ʱ OpenCV Ų
     Tensor temp;
-    temp.shape = { floatImage.channels(), floatImage.rows, floatImage.cols };
-    temp.data = std::move(floatFinal);
-    //  Tensor蹹캯 vector άȲ
+    image_to_tensor(image, 0, 0, temp, layout == TensorLayout::HWC ? TensorLayout::HWC : TensorLayout::CHW);
     return temp;
 }
 
 void CNN::add_layer(shared_ptr<layer> Layer)
 {
+    // ھȫӲ֮ʱǰһ epilogueٵͼдһ
+    Activation activation;
+    if (!layers.empty() && as_activation(Layer, activation))
+    {
+        shared_ptr<Conv> conv = dynamic_pointer_cast<Conv>(layers.back());
+        if (conv && conv->get_activation().is_identity())
+        {
+            conv->set_activation(activation);
+            return;
+        }
+        shared_ptr<fc_layer> fc = dynamic_pointer_cast<fc_layer>(layers.back());
+        if (fc && fc->get_activation().is_identity())
+        {
+            fc->set_activation(activation);
+            return;
+        }
+    }
+
     layers.push_back(Layer);
+    set_layout(layout);
+}
+
+void CNN::set_layout(TensorLayout m_layout)
+{
+    layout = m_layout;
+    shared_ptr<Conv> last_conv;
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        if (shared_ptr<Conv> conv = dynamic_pointer_cast<Conv>(layers[i]))
+        {
+            bool blocked = layout != TensorLayout::CHW && conv->supports_blocked_output();
+            conv->set_output_layout(blocked ? layout : TensorLayout::CHW);
+            last_conv = conv;
+        }
+        // HWC ͼչƽȫӲ㣺һͨһȨ
+        bool hwc_flatten = layout == TensorLayout::HWC && last_conv && last_conv->get_output_layout() == TensorLayout::HWC;
+        if (hwc_flatten && dynamic_pointer_cast<flattenLayer>(layers[i]) && i + 1 < layers.size())
+        {
+            if (shared_ptr<fc_layer> fc = dynamic_pointer_cast<fc_layer>(layers[i + 1]))
+            {
+                fc->prepare_channels_last(last_conv->get_out_channels());
+            }
+        }
+    }
 }
 
 Tensor CNN::predict(Tensor& input)
 {
-    Tensor current_tensor_input = input;
-    for (auto m_layer : layers)
+    return run_layers(0, input, layers.size());
+}
+
+Tensor CNN::predict(const ImageView& input)
+{
+    return run_view(input, layers.size());
+}
+
+vector<Tensor> CNN::predict_batch(const vector<Tensor>& inputs)
+{
+    size_t split = layers.size();
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        if (dynamic_pointer_cast<fc_layer>(layers[i]))
+        {
+            split = i;
+            break;
+        }
+    }
+
+    vector<Tensor> outputs;
+    if (split == layers.size() || inputs.size() <= 1)
+    {
+        for (const Tensor& input : inputs) outputs.push_back(run_layers(0, input, layers.size()));
+        return outputs;
+    }
+
+    // 1. ִУõһάд [N, in]
+    int batch = static_cast<int>(inputs.size());
+    Tensor features;
+    for (int n = 0; n < batch; n++)
+    {
+        Tensor current = inputs[n];
+        for (size_t i = 0; i < split; i++) run_layer(*layers[i], current);
+        if (current.shape.size() != 1)
+        {
+            throw invalid_argument("CNN predict_batch: the first fc_layer must receive a flattened tensor");
+        }
+        if (n == 0)
+        {
+            features.shape = {batch, current.shape[0]};
+            features.data.resize(features.size());
+            features.layout = current.layout;
+        }
+        else if (current.shape[0] != features.shape[1] || current.layout != features.layout)
+        {
+            throw invalid_argument("CNN predict_batch: inputs produce features of different sizes");
+        }
+        copy(current.data.begin(), current.data.end(), features.data.begin() + static_cast<size_t>(n) * features.shape[1]);
+    }
+
+    // 2. ֮ fc_layer 㣬 (softMax) ִ
+    for (size_t i = split; i < layers.size(); i++)
+    {
+        if (dynamic_pointer_cast<fc_layer>(layers[i]))
+        {
+            Tensor next;
+            layers[i]->forward(features, next);
+            features = std::move(next);
+            continue;
+        }
+
+        Tensor next;
+        for (int n = 0; n < batch; n++)
+        {
+            Tensor row({features.shape[1]});
+            row.layout = features.layout;
+            copy(features.data.begin() + static_cast<size_t>(n) * row.size(),
+                 features.data.begin() + static_cast<size_t>(n + 1) * row.size(), row.data.begin());
+            run_layer(*layers[i], row);
+            if (n == 0)
+            {
+                next.shape = {batch, row.size()};
+                next.data.resize(next.size());
+                next.layout = row.layout;
+            }
+            copy(row.data.begin(), row.data.end(), next.data.begin() + static_cast<size_t>(n) * row.size());
+        }
+        features = std::move(next);
+    }
+
+    // 3. ÿ
+    int width = features.shape[1];
+    for (int n = 0; n < batch; n++)
+    {
+        Tensor row({width});
+        copy(features.data.begin() + static_cast<size_t>(n) * width, features.data.begin() + static_cast<size_t>(n + 1) * width,
+             row.data.begin());
+        outputs.push_back(std::move(row));
+    }
+    return outputs;
+}
+
+size_t CNN::logits_end() const
+{
+    if (!layers.empty() && dynamic_pointer_cast<softMax>(layers.back()))
     {
-        Tensor current_tensor_output;
+        return layers.size() - 1;
+    }
+    return layers.size();
+}
 
-        m_layer->forward(current_tensor_input, current_tensor_output);//ÿһforwardԹڴ˲ٽС
-        //cout << current_tensor_output.data[1] << endl;
-        current_tensor_input = current_tensor_output;
+Tensor CNN::predict_logits(Tensor& input)
+{
+    return run_layers(0, input, logits_end());
+}
+
+Tensor CNN::predict_logits(const ImageView& input)
+{
+    return run_view(input, logits_end());
+}
+
+vector<ClassScore> CNN::predict_topk(Tensor& input, int k)
+{
+    return top_k(predict_logits(input), k);
+}
+
+vector<ClassScore> CNN::predict_topk(const ImageView& input, int k)
+{
+    return top_k(predict_logits(input), k);
+}
+
+bool CNN::predict_binary(Tensor& input, int positive, float threshold, float* margin)
+{
+    return binary_decision(predict_logits(input), positive, threshold, margin);
+}
+
+bool CNN::predict_binary(const ImageView& input, int positive, float threshold, float* margin)
+{
+    return binary_decision(predict_logits(input), positive, threshold, margin);
+}
+
+Tensor CNN::run_view(const ImageView& input, size_t last)
+{
+    if (last == 0)
+    {
+        return input.to_tensor();
+    }
+
+    shared_ptr<Conv> first_conv = dynamic_pointer_cast<Conv>(layers[0]);
+    if (!first_conv)
+    {
+        // һ޷ֱӶȡͼ˻Ϊһο
+        return run_layers(0, input.to_tensor(), last);
+    }
+
+    Tensor first_output;
+    first_conv->forward(input, first_output);
+    return run_layers(1, std::move(first_output), last);
+}
+
+Tensor CNN::run_layers(size_t first, Tensor current_tensor_input, size_t last)
+{
+    // Ԫز flatten ֱӸдǰƶݿ
+    for (size_t i = first; i < last; i++)
+    {
+        run_layer(*layers[i], current_tensor_input);//ÿһforwardԹڴ˲ٽС
+    }
+    if (current_tensor_input.layout != TensorLayout::CHW)
+    {
+        return to_planar(current_tensor_input);
     }
     return current_tensor_input;
 }
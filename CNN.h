@@ -7,12 +7,16 @@
 
 #include "Tensor.h"
 #include "Relu.h"
+#include "Activation.h"
 #include "maxPooling.h"
+#include "avgPooling.h"
 #include "softMax.h"
 #include "fc_layer.h"
 #include "flatten.h"
 #include "layer.h"
 #include "Conv.h"
+#include "ImageView.h"
+#include "Layout.h"
 //------------------------
 #include <vector>
 #include <iostream>
@@ -21,15 +25,51 @@
 
 using namespace std;
 
+// predict_topk һ± logit (fc δ softmax)
+struct ClassScore
+{
+	int index = 0;
+	float logit = 0.0f;
+};
+
 class CNN
 {
 private:
 	vector<shared_ptr<layer>> layers;
+	TensorLayout layout = TensorLayout::CHW;
+	// ӵ first 㿪ʼִе last ֮ǰ ( last)
+	Tensor run_layers(size_t first, Tensor current_tensor_input, size_t last);
+	Tensor run_view(const ImageView& input, size_t last);
+	// ĩβ softMax 򷵻±꣬򷵻زֻҪʱܵＴ
+	size_t logits_end() const;
 public:
 	CNN() = default;
 	Tensor predict(Tensor& input);
+	// 㿽ڣֱӰⲿһ㣻һΪ Conv ʱתȡʱ
+	Tensor predict(const ImageView& input);
+	// һ fc_layer ֮ǰִУ֮Ѹжѵ [N, in]
+	// ȫӲ GEMM һδ (ִ) predict λһ
+	vector<Tensor> predict_batch(const vector<Tensor>& inputs);
+	// ĩβ softMax fc  logits
+	Tensor predict_logits(Tensor& input);
+	Tensor predict_logits(const ImageView& input);
+	//  logit ӴСǰ k softmax һ£ʡȥ exp һ
+	vector<ClassScore> predict_topk(Tensor& input, int k = 1);
+	vector<ClassScore> predict_topk(const ImageView& input, int k = 1);
+	// ֵжp(positive) > threshold ȼ logit  > log(threshold / (1 - threshold))
+	//  softmaxmargin ǿʱд logit Ҫǡ
+	bool predict_binary(Tensor& input, int positive = 0, float threshold = 0.5f, float* margin = nullptr);
+	bool predict_binary(const ImageView& input, int positive = 0, float threshold = 0.5f, float* margin = nullptr);
+	//  Conv / fc_layer ֮ reluLayer  activationLayer ΪĲ룬ǲǰһ epilogue
 	void add_layer(shared_ptr<layer> Layer);
+	// мͼĲ֣CHWc / HWC ʱͨɷֿľ㰴òػ ReLU 벼֣
+	// ԭΪ CHWCHWc  flatten ԭ CHW λһ£HWC ֱչƽ
+	// ȫӲ㻻һŵȨأֻۼ˳롣
+	// HWC ʱ load_image_as_tensor Ҳֱ HWCʡȥԤеת
+	void set_layout(TensorLayout m_layout);
+	TensorLayout get_layout() const { return layout; }
 	Tensor load_image_as_tensor(const char* path);
+	const vector<shared_ptr<layer>>& get_layers() const { return layers; }
 	~CNN() = default;
 };
 
@@ -56,6 +56,20 @@ Conv::Conv(int pad, int stride, int kernel_size, int in_channels, int out_channe
         throw std::invalid_argument("SimpleConvBNLayer: biases_data pointer is null.");
     }
 
+    // --- 3. ͨɷֿʱԤȨأ compute_blocked ȡ ---
+    if (blockable(out_channels_)) {
+        const int kk = kernel_size_ * kernel_size_;
+        packed_weights_.resize(weights_.data.size());
+        for (int oc = 0; oc < out_channels_; ++oc) {
+            for (int ic = 0; ic < in_channels_; ++ic) {
+                for (int k = 0; k < kk; ++k) {
+                    size_t dst = ((static_cast<size_t>(oc / channel_block) * in_channels_ + ic) * kk + k) * channel_block + oc % channel_block;
+                    packed_weights_[dst] = weights_.data[(oc * in_channels_ + ic) * kk + k];
+                }
+            }
+        }
+    }
+
     // std::cout << "SimpleConvBNLayer constructed with kernel_size=" << kernel_size_
     //           << ", stride=" << stride_ << ", pad=" << pad_
     //           << ", in_channels=" << in_channels_ << ", out_channels=" << out_channels_ << std::endl; // Ϣ
@@ -96,6 +110,28 @@ std::vector<int> Conv::get_output_shape(const std::vector<int>& input_shape) con
 }
 
 
+// ѡ
+void Conv::set_output_layout(TensorLayout layout) {
+    if (layout != TensorLayout::CHW && !supports_blocked_output()) {
+        throw std::invalid_argument("SimpleConvBNLayer: CHWc/HWC output needs out_channels to be a multiple of " + std::to_string(channel_block));
+    }
+    output_layout_ = layout;
+}
+
+// дǰִеļ
+void Conv::set_activation(const Activation& activation) {
+    epilogue_ = activation;
+}
+
+// get_spatial_window ʵ
+bool Conv::get_spatial_window(spatial_window& window) const {
+    window.kernel_h = window.kernel_w = kernel_size_;
+    window.stride_h = window.stride_w = stride_;
+    window.pad_h = window.pad_w = pad_;
+    return true;
+}
+
+
 // forward ʵ
 //  Tensor ִо
 void Conv::forward(const Tensor& input, Tensor& output) {
@@ -116,56 +152,317 @@ void Conv::forward(const Tensor& input, Tensor& output) {
     // 2. ȷ Tensor ״ʹС
     //  get_output_shape ״
     std::vector<int> output_shape = get_output_shape(input.shape);
-    int out_c = output_shape[0];
     int out_h = output_shape[1];
     int out_w = output_shape[2];
 
     output.shape = output_shape; //  Tensor ״
     output.data.resize(output.size()); // ״ output.data ĴСڴ
+    output.layout = output_layout_;
 
 
-    // 3. ļ㣺
-    //  Tensor ÿһλ [oc, oh, ow]
-    for (int oc = 0; oc < out_c; ++oc) { // ͨ (Ӧ˲)
-        for (int oh = 0; oh < out_h; ++oh) { // ߶
-            for (int ow = 0; ow < out_w; ++ow) { // 
+    // 3. ļ㣺 (һ಻ CHW Ȩѷֿʱ߷ֿ汾)
+    bool blocked = input.layout != TensorLayout::CHW || output_layout_ != TensorLayout::CHW;
+    if (blocked && supports_blocked_output()) {
+        compute_blocked(input.data.data(), input.layout, in_h, in_w, pad_, pad_,
+                        output.data.data(), output_layout_, out_h, out_w, out_h * out_w);
+    }
+    else if (input.layout != TensorLayout::CHW) {
+        Tensor planar = to_planar(input);
+        compute(planar.data.data(), in_h, in_w, pad_, pad_, output.data.data(), out_h, out_w, out_h * out_w);
+    }
+    else {
+        compute(input.data.data(), in_h, in_w, pad_, pad_, output.data.data(), out_h, out_w, out_h * out_w);
+    }
+}
+
+// forward_region ʵ
+//  forward ͬļ㣬ߴɵ÷ (Ϊͼеһ)
+void Conv::forward_region(const Tensor& input, Tensor& output, int pad_top, int pad_left, int out_h, int out_w) {
+    if (input.shape.size() != 3 || input.shape[0] != in_channels_) {
+        throw std::invalid_argument("SimpleConvBNLayer forward_region: Input tensor must be 3D [C, H, W] with matching channels.");
+    }
+
+    output.shape = { out_channels_, out_h, out_w };
+    output.data.resize(output.size());
+    output.layout = TensorLayout::CHW;
+    if (input.layout != TensorLayout::CHW) {
+        Tensor planar = to_planar(input);
+        compute(planar.data.data(), input.shape[1], input.shape[2], pad_top, pad_left, output.data.data(), out_h, out_w, out_h * out_w);
+        return;
+    }
+    compute(input.data.data(), input.shape[1], input.shape[2], pad_top, pad_left, output.data.data(), out_h, out_w, out_h * out_w);
+}
+
+// ļ
+// Ϊڲ߿ڲ (interior_range) Ĵȫڣȡ߽жϣ3x3 ȫչ
+// ߿ֻΧխһȦԽ粿Ϊ 0 ()ֵۼ˳ͬ (ickhkw)жһ
+void Conv::compute(const float* in, int in_h, int in_w, int pad_top, int pad_left,
+                   float* out, int out_h, int out_w, int out_cstride) const {
+    const float* w_data = weights_.data.data();
+    const int kk = kernel_size_ * kernel_size_;
+    const int in_plane = in_h * in_w;
+
+    if (stride_ == 2) {
+        compute_stride2(in, in_h, in_w, pad_top, pad_left, out, out_h, out_w, out_cstride);
+        return;
+    }
 
-                float sum = 0.0f; // ʼǰλõۼֵ
+    int oh_lo, oh_hi, ow_lo, ow_hi;
+    interior_range(out_h, in_h, pad_top, oh_lo, oh_hi);
+    interior_range(out_w, in_w, pad_left, ow_lo, ow_hi);
+
+    // ڲһwindow ָ򴰿Ͻ ( 0 ͨ)
+    auto interior = [&](const float* w_oc, const float* window) {
+        float sum = 0.0f;
+        for (int ic = 0; ic < in_channels_; ++ic) {
+            const float* r0 = window + ic * in_plane;
+            const float* w_c = w_oc + ic * kk;
+            if (kernel_size_ == 3) {
+                const float* r1 = r0 + in_w;
+                const float* r2 = r1 + in_w;
+                sum += r0[0] * w_c[0]; sum += r0[1] * w_c[1]; sum += r0[2] * w_c[2];
+                sum += r1[0] * w_c[3]; sum += r1[1] * w_c[4]; sum += r1[2] * w_c[5];
+                sum += r2[0] * w_c[6]; sum += r2[1] * w_c[7]; sum += r2[2] * w_c[8];
+                continue;
+            }
+            for (int kh = 0; kh < kernel_size_; ++kh) {
+                const float* row = r0 + kh * in_w;
+                const float* w_row = w_c + kh * kernel_size_;
+                for (int kw = 0; kw < kernel_size_; ++kw) sum += row[kw] * w_row[kw];
+            }
+        }
+        return sum;
+    };
 
-                // 㵱ǰλ [oc, oh, ow] Ӧ Tensor еľʼ (Ͻ)
-                // ǲ
-                int ih_start = oh * stride_ - pad_;
-                int iw_start = ow * stride_ - pad_;
+    for (int oc = 0; oc < out_channels_; ++oc) { // ͨ (Ӧ˲)
+        const float* w_oc = w_data + oc * in_channels_ * kk; // weights_({oc, 0, 0, 0})
+        const float bias = biases_.data[oc];
+        float* out_c = out + oc * out_cstride;
 
-                // --- вѭͨ ---
-                for (int ic = 0; ic < in_channels_; ++ic) { // ͨ (˲)
+        for (int oh = 0; oh < out_h; ++oh) { // ߶
+            float* out_row = out_c + oh * out_w;
+            if (oh < oh_lo || oh >= oh_hi) {
+                for (int ow = 0; ow < out_w; ++ow) out_row[ow] = epilogue_(border_sum(in, in_h, in_w, oc, oh * stride_ - pad_top, ow * stride_ - pad_left) + bias);
+                continue;
+            }
 
-                    // --- ڲѭ˵ ---
-                    for (int kh = 0; kh < kernel_size_; ++kh) { // ˸߶
-                        for (int kw = 0; kw < kernel_size_; ++kw) { // ˿
+            int ih_start = oh * stride_ - pad_top;
+            for (int ow = 0; ow < ow_lo; ++ow) out_row[ow] = epilogue_(border_sum(in, in_h, in_w, oc, ih_start, ow * stride_ - pad_left) + bias);
+            for (int ow = ow_lo; ow < ow_hi; ++ow) {
+                const float* window = in + ih_start * in_w + ow * stride_ - pad_left;
+                out_row[ow] = epilogue_(interior(w_oc, window) + bias);
+            }
+            for (int ow = ow_hi; ow < out_w; ++ow) out_row[ow] = epilogue_(border_sum(in, in_h, in_w, oc, ih_start, ow * stride_ - pad_left) + bias);
+        }
+    }
+}
 
-                            //  Tensor еʵ
-                            int ih = ih_start + kh;
-                            int iw = iw_start + kw;
+// ߿ϵһ (ƫ)ڴ (ih_start, iw_start) ʼжǷԽ
+float Conv::border_sum(const float* in, int in_h, int in_w, int oc, int ih_start, int iw_start) const {
+    const int kk = kernel_size_ * kernel_size_;
+    const float* w_oc = weights_.data.data() + oc * in_channels_ * kk;
+    float sum = 0.0f;
+    for (int ic = 0; ic < in_channels_; ++ic) {
+        const float* in_c = in + ic * in_h * in_w;
+        const float* w_c = w_oc + ic * kk;
+        for (int kh = 0; kh < kernel_size_; ++kh) {
+            int ih = ih_start + kh;
+            for (int kw = 0; kw < kernel_size_; ++kw) {
+                int iw = iw_start + kw;
+                if (ih >= 0 && ih < in_h && iw >= 0 && iw < in_w) {
+                    sum += in_c[ih * in_w + iw] * w_c[kh * kernel_size_ + kw];
+                }
+            }
+        }
+    }
+    return sum;
+}
 
-                            // 鵱ǰǷ߽
-                            // ֻЧ߽ڵزŲ㣬Ϊ0 ()
-                            if (ih >= 0 && ih < in_h && iw >= 0 && iw < in_w) {
-                                //  Tensor Ԫ: input({ic, ih, iw})
-                                // Ȩ Tensor Ԫ: weights_({oc, ic, kh, kw})
-                                sum += input({ ic, ih, iw }) * weights_({ oc, ic, kh, kw });
+// Ϊ 2 ľ
+//  2 УֱӶȡǿ粽ʡÿڲȰҪõ in_channels * k 
+// żλ (ÿֻһΣͨ)˺ͷ (kh, kw) һȡ
+// ĳλһΣλۼӼÿ԰ ickhkw ˳ۼӣ compute һ
+void Conv::compute_stride2(const float* in, int in_h, int in_w, int pad_top, int pad_left,
+                           float* out, int out_h, int out_w, int out_cstride) const {
+    const int k = kernel_size_;
+    const int kk = k * k;
+    const int in_plane = in_h * in_w;
+    const int half_w = (in_w + 1) / 2;
+
+    int oh_lo, oh_hi, ow_lo, ow_hi;
+    interior_range(out_h, in_h, pad_top, oh_lo, oh_hi);
+    interior_range(out_w, in_w, pad_left, ow_lo, ow_hi);
+    const int span = ow_hi - ow_lo;
+    constexpr int chunk = 16;
+
+    std::vector<float> phases(static_cast<size_t>(in_channels_) * k * 2 * half_w);  // [ic][kh][ż/][ / 2]
+    std::vector<float> acc(std::max(span, 0));
+
+    for (int oh = 0; oh < out_h; ++oh) {
+        int ih_start = oh * 2 - pad_top;
+        bool interior_row = oh >= oh_lo && oh < oh_hi && span > 0;
+
+        if (interior_row) {
+            for (int ic = 0; ic < in_channels_; ++ic) {
+                for (int kh = 0; kh < k; ++kh) {
+                    const float* row = in + ic * in_plane + (ih_start + kh) * in_w;
+                    float* even = phases.data() + static_cast<size_t>(ic * k + kh) * 2 * half_w;
+                    float* odd = even + half_w;
+                    for (int j = 0; j < in_w / 2; ++j) {
+                        even[j] = row[2 * j];
+                        odd[j] = row[2 * j + 1];
+                    }
+                    if (in_w % 2) even[half_w - 1] = row[in_w - 1];
+                }
+            }
+        }
+
+        for (int oc = 0; oc < out_channels_; ++oc) {
+            const float bias = biases_.data[oc];
+            float* out_row = out + oc * out_cstride + oh * out_w;
+            if (!interior_row) {
+                for (int ow = 0; ow < out_w; ++ow) out_row[ow] = epilogue_(border_sum(in, in_h, in_w, oc, ih_start, ow * 2 - pad_left) + bias);
+                continue;
+            }
+
+            // ÿδ chunk ۼֵڼĴгͷд
+            const float* w_oc = weights_.data.data() + oc * in_channels_ * kk;
+            for (int t0 = 0; t0 < span; t0 += chunk) {
+                int n = std::min(chunk, span - t0);
+                float sums[chunk] = {};
+                for (int ic = 0; ic < in_channels_; ++ic) {
+                    for (int kh = 0; kh < k; ++kh) {
+                        const float* even = phases.data() + static_cast<size_t>(ic * k + kh) * 2 * half_w;
+                        const float* w_row = w_oc + ic * kk + kh * k;
+                        for (int kw = 0; kw < k; ++kw) {
+                            int col = (ow_lo + t0) * 2 - pad_left + kw;   // εһȡУڲ֤Ǹ
+                            const float* src = even + (col & 1) * half_w + (col >> 1);
+                            const float w = w_row[kw];
+                            if (n == chunk) {
+                                for (int t = 0; t < chunk; ++t) sums[t] += src[t] * w;
+                            }
+                            else {
+                                for (int t = 0; t < n; ++t) sums[t] += src[t] * w;
                             }
-                            //  ih  iw  Tensor ʵʱ߽ ( padding 򴰿ڲ)
-                            // ôݾĶ壬ǱΪ 0ԲҪʽ 0
                         }
                     }
                 }
-                // ƫ (bias ÿͨһֵ)
-                sum += biases_.data[oc]; // biases_  1D Tensorֱ oc 
+                std::copy(sums, sums + n, acc.begin() + t0);
+            }
+
+            for (int ow = 0; ow < ow_lo; ++ow) out_row[ow] = epilogue_(border_sum(in, in_h, in_w, oc, ih_start, ow * 2 - pad_left) + bias);
+            for (int t = 0; t < span; ++t) out_row[ow_lo + t] = epilogue_(acc[t] + bias);
+            for (int ow = ow_hi; ow < out_w; ++ow) out_row[ow] = epilogue_(border_sum(in, in_h, in_w, oc, ih_start, ow * 2 - pad_left) + bias);
+        }
+    }
+}
+
+// һάϴȫ [0, in) ڵΧ [lo, hi)o * stride - pad >= 0  o * stride - pad + k <= in
+void Conv::interior_range(int out, int in, int pad, int& lo, int& hi) const {
+    lo = (pad + stride_ - 1) / stride_;
+    int last = in + pad - kernel_size_;
+    hi = last < 0 ? 0 : last / stride_ + 1;
+    hi = std::min(hi, out);
+    lo = std::min(lo, hi);
+}
+
+// ֿļ
+// ÿһۼ channel_block ֵͨ㲥ֿȨصһͨۼӡ
+// ڵķΧԤڲѭ߽жϣλ compute ͬۼ
+void Conv::compute_blocked(const float* in, TensorLayout in_layout, int in_h, int in_w, int pad_top, int pad_left,
+                           float* out, TensorLayout out_layout, int out_h, int out_w, int out_plane) const {
+    const int k = kernel_size_;
+    const int in_plane = in_h * in_w;
+    // еļ
+    const int step = in_layout == TensorLayout::CHWc ? channel_block : (in_layout == TensorLayout::HWC ? in_channels_ : 1);
+
+    for (int ob = 0; ob < out_channels_ / channel_block; ++ob) {
+        const float* w_block = packed_weights_.data() + static_cast<size_t>(ob) * in_channels_ * k * k * channel_block;
+        const float* bias = biases_.data.data() + ob * channel_block;
+
+        for (int oh = 0; oh < out_h; ++oh) {
+            int ih_start = oh * stride_ - pad_top;
+            int kh_lo = std::max(0, -ih_start), kh_hi = std::min(k, in_h - ih_start);
+            for (int ow = 0; ow < out_w; ++ow) {
+                int iw_start = ow * stride_ - pad_left;
+                int kw_lo = std::max(0, -iw_start), kw_hi = std::min(k, in_w - iw_start);
+
+                float acc[channel_block] = {};
+                for (int ic = 0; ic < in_channels_; ++ic) {
+                    const float* in_c = in + ic;
+                    if (in_layout == TensorLayout::CHWc) in_c = in + static_cast<size_t>(ic / channel_block) * in_plane * channel_block + ic % channel_block;
+                    else if (in_layout == TensorLayout::CHW) in_c = in + static_cast<size_t>(ic) * in_plane;
+                    const float* w_c = w_block + static_cast<size_t>(ic) * k * k * channel_block;
+                    for (int kh = kh_lo; kh < kh_hi; ++kh) {
+                        const float* in_row = in_c + static_cast<size_t>((ih_start + kh) * in_w + iw_start) * step;
+                        const float* w_row = w_c + kh * k * channel_block;
+                        for (int kw = kw_lo; kw < kw_hi; ++kw) {
+                            float x = in_row[kw * step];
+                            const float* w = w_row + kw * channel_block;
+                            for (int v = 0; v < channel_block; ++v) acc[v] += x * w[v];
+                        }
+                    }
+                }
 
-                //  Tensor ĶӦλ
-                output({ oc, oh, ow }) = sum;
+                if (out_layout == TensorLayout::CHWc) {
+                    float* dst = out + (static_cast<size_t>(ob) * out_plane + oh * out_w + ow) * channel_block;
+                    for (int v = 0; v < channel_block; ++v) dst[v] = epilogue_(acc[v] + bias[v]);
+                }
+                else if (out_layout == TensorLayout::HWC) {
+                    float* dst = out + static_cast<size_t>(oh * out_w + ow) * out_channels_ + ob * channel_block;
+                    for (int v = 0; v < channel_block; ++v) dst[v] = epilogue_(acc[v] + bias[v]);
+                }
+                else {
+                    for (int v = 0; v < channel_block; ++v) {
+                        out[static_cast<size_t>(ob * channel_block + v) * out_plane + oh * out_w + ow] = epilogue_(acc[v] + bias[v]);
+                    }
+                }
             }
         }
     }
-}
\ No newline at end of file
+}
+
+// ֱӶȡⲿͼ forward
+// ÿֻҪ kernel_size УתС computeԽ ()  0
+void Conv::forward(const ImageView& input, Tensor& output) {
+    input.validate();
+    if (input.channels != in_channels_) {
+        throw std::invalid_argument("SimpleConvBNLayer forward: Input channels mismatch for forward pass.");
+    }
+
+    std::vector<int> output_shape = get_output_shape(input.shape());
+    int out_h = output_shape[1];
+    int out_w = output_shape[2];
+
+    output.shape = output_shape;
+    output.data.resize(output.size());
+    output.layout = output_layout_;
+
+    int in_w = input.width;
+    std::vector<float> band(static_cast<size_t>(in_channels_) * kernel_size_ * in_w);
+
+    for (int oh = 0; oh < out_h; ++oh) {
+        int ih_start = oh * stride_ - pad_;
+        for (int ic = 0; ic < in_channels_; ++ic) {
+            for (int kh = 0; kh < kernel_size_; ++kh) {
+                float* dst = band.data() + (ic * kernel_size_ + kh) * in_w;
+                int ih = ih_start + kh;
+                if (ih >= 0 && ih < input.height) {
+                    input.read_row(ic, ih, dst);
+                }
+                else {
+                    std::fill(dst, dst + in_w, 0.0f);
+                }
+            }
+        }
+        // Ѱ䣬ֻ账
+        if (output_layout_ != TensorLayout::CHW) {
+            int pixel = output_layout_ == TensorLayout::CHWc ? channel_block : out_channels_;  // ÿռõԪ
+            compute_blocked(band.data(), TensorLayout::CHW, kernel_size_, in_w, 0, pad_,
+                            output.data.data() + static_cast<size_t>(oh) * out_w * pixel, output_layout_, 1, out_w, out_h * out_w);
+        }
+        else {
+            compute(band.data(), kernel_size_, in_w, 0, pad_, output.data.data() + oh * out_w, 1, out_w, out_h * out_w);
+        }
+    }
+}
@@ -6,6 +6,9 @@
 
 #include "layer.h"  //  Layer Ķ
 #include "Tensor.h" //  Tensor ṹĶ
+#include "ImageView.h" // ⲿͼ (һֱӶȡ)
+#include "Layout.h" // CHWc ͨС벼ת
+#include "Activation.h" // дǰļ (epilogue)
 #include <vector>   //  std::vector
 
 // ---  ---
@@ -19,6 +22,31 @@ private:
     int kernel_size_;   // ˱߳ (Ƿκ)
     int in_channels_;   // ͨ (ʽ洢Ҳ weights_.shape[1] õ)
     int out_channels_;  // ͨ (ʽ洢Ҳ weights_.shape[0] õ)
+    std::vector<float> packed_weights_;  // ֿͨŵȨ [out_channels / c][in_channels][k][k][c]ͨɷֿʱΪ
+    TensorLayout output_layout_ = TensorLayout::CHW;  // forward Ĳ
+    Activation epilogue_;  // ÿڼƫúдǰִеļĬϲ任
+
+    // ļ㣺in Ϊ {in_channels, in_h, in_w} ݣ
+    //  (oh, ow) ȡ (oh * stride - pad_top + kh, ow * stride - pad_left + kw)ԽΪ 0
+    // д out[oc * out_cstride + oh * out_w + ow]
+    void compute(const float* in, int in_h, int in_w, int pad_top, int pad_left,
+                 float* out, int out_h, int out_w, int out_cstride) const;
+
+    // һάϴȫڵΧ [lo, hi)ΪҪ䴦ı߿
+    void interior_range(int out, int in, int pad, int& lo, int& hi) const;
+    // ߿һλ (oc,  ih_start, iw_start) ۼӺͣƫ
+    float border_sum(const float* in, int in_h, int in_w, int oc, int ih_start, int iw_start) const;
+
+    // stride Ϊ 2 ʱ compute ʵ֣аżвֺۼӣ compute ͬ
+    void compute_stride2(const float* in, int in_h, int in_w, int pad_top, int pad_left,
+                         float* out, int out_h, int out_w, int out_cstride) const;
+
+    // ֿ汾һμͬһص channel_block ͨۼ˳ compute ͬλһ¡
+    // Ϊ CHWCHWc  HWCout_layout Ϊ CHW ʱд out[oc * out_plane + oh * out_w + ow]
+    // Ϊ CHWc ʱд out[((oc / c) * out_plane + oh * out_w + ow) * c + oc % c]
+    // Ϊ HWC ʱд out[(oh * out_w + ow) * out_channels + oc]
+    void compute_blocked(const float* in, TensorLayout in_layout, int in_h, int in_w, int pad_top, int pad_left,
+                         float* out, TensorLayout out_layout, int out_h, int out_w, int out_plane) const;
 
 public:
     // 캯ԭʼȨغƫָ뼰бҪ
@@ -29,10 +57,30 @@ public:
     //  Tensor (3D ͼ) ִо㣬 Tensor
     void forward(const Tensor& input, Tensor& output) override;
 
+    // ֱӶȡⲿͼ (uint8/floatCHW/HWCⲽ)תڶȡʱɣ
+    // ֻռ kernel_size еʱ壬ͼ
+    void forward(const ImageView& input, Tensor& output);
+
+    // ںϵļм·дǰִУʡȥһζд
+    void set_activation(const Activation& activation);
+    const Activation& get_activation() const { return epilogue_; }
+
+    // ѡ forward ֣CHWc  HWC Ҫͨ channel_block 
+    void set_output_layout(TensorLayout layout);
+    TensorLayout get_output_layout() const { return output_layout_; }
+    bool supports_blocked_output() const { return !packed_weights_.empty(); }
+    int get_out_channels() const { return out_channels_; }
+
     // ʵֻе get_output_shape 
     // ״˳ߴ硢״
     std::vector<int> get_output_shape(const std::vector<int>& input_shape) const override;
 
+    // ˡ (߿ͬ)
+    bool get_spatial_window(spatial_window& window) const override;
+
+    // ʽ out_h x out_w  (ֿ)Ϊ CHW
+    void forward_region(const Tensor& input, Tensor& output, int pad_top, int pad_left, int out_h, int out_w) override;
+
     // 
     ~Conv() override = default;
 };
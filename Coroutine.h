@@ -0,0 +1,154 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#include "ThreadPool.h"
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <future>
+#include <optional>
+#include <utility>
+
+using namespace std;
+
+// 惰性协程任务：创建后不执行，被 co_await 时才开始，结束时通过对称转移恢复等待者
+template <typename T>
+class Task
+{
+public:
+    struct promise_type
+    {
+        optional<T> value;
+        exception_ptr error;
+        coroutine_handle<> continuation;
+
+        Task get_return_object() { return Task(coroutine_handle<promise_type>::from_promise(*this)); }
+        suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept { return false; }
+            coroutine_handle<> await_suspend(coroutine_handle<promise_type> self) noexcept
+            {
+                coroutine_handle<> next = self.promise().continuation;
+                return next ? next : noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void return_value(T result) { value = std::move(result); }
+        void unhandled_exception() { error = current_exception(); }
+    };
+
+    Task(Task&& other) noexcept : handle(exchange(other.handle, nullptr)) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task()
+    {
+        if (handle) handle.destroy();
+    }
+
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter
+        {
+            coroutine_handle<promise_type> handle;
+
+            bool await_ready() noexcept { return false; }
+            coroutine_handle<> await_suspend(coroutine_handle<> caller) noexcept
+            {
+                handle.promise().continuation = caller;
+                return handle;
+            }
+            T await_resume()
+            {
+                if (handle.promise().error) rethrow_exception(handle.promise().error);
+                return std::move(*handle.promise().value);
+            }
+        };
+        return Awaiter{handle};
+    }
+
+private:
+    coroutine_handle<promise_type> handle;
+
+    explicit Task(coroutine_handle<promise_type> m_handle) : handle(m_handle) {}
+};
+
+// 立即开始、结束后自行销毁的协程，用于从普通代码中发起请求
+struct Detached
+{
+    struct promise_type
+    {
+        Detached get_return_object() { return {}; }
+        suspend_never initial_suspend() noexcept { return {}; }
+        suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { terminate(); }
+    };
+};
+
+// co_await 时挂起当前协程，把 work 交给线程池执行，完成后在该工作线程上恢复协程。
+// 等待期间不占用任何线程
+template <typename T>
+class PoolAwaitable
+{
+private:
+    ThreadPool& pool;
+    function<T()> work;
+    optional<T> result;
+    exception_ptr error;
+
+public:
+    PoolAwaitable(ThreadPool& m_pool, function<T()> m_work) : pool(m_pool), work(std::move(m_work)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(coroutine_handle<> waiting)
+    {
+        // 工作线程可能在 submit 返回前就恢复协程，此后不能再访问 this
+        pool.submit([this, waiting] {
+            try
+            {
+                result = work();
+            }
+            catch (...)
+            {
+                error = current_exception();
+            }
+            waiting.resume();
+        });
+    }
+
+    T await_resume()
+    {
+        if (error) rethrow_exception(error);
+        return std::move(*result);
+    }
+};
+
+// 在当前线程阻塞等待 task 完成 (用于 main 与测试，服务代码中应使用 co_await)
+template <typename T>
+T sync_wait(Task<T> task)
+{
+    promise<T> done;
+    future<T> result = done.get_future();
+    [](Task<T> inner, promise<T>& out) -> Detached {
+        try
+        {
+            out.set_value(co_await std::move(inner));
+        }
+        catch (...)
+        {
+            out.set_exception(current_exception());
+        }
+    }(std::move(task), done);
+    return result.get();
+}
+
+#endif //COROUTINE_H
@@ -0,0 +1,261 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "Detector.h"
+#include "Preprocess.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+
+using namespace std;
+
+FaceDetector::FaceDetector(const CNN& cnn, int input_h, int input_w) : window_h(input_h), window_w(input_w)
+{
+    const vector<shared_ptr<layer>>& layers = cnn.get_layers();
+
+    size_t i = 0;
+    while (i < layers.size() && !dynamic_pointer_cast<flattenLayer>(layers[i]))
+    {
+        features.push_back(layers[i]);
+        i++;
+    }
+    if (i + 1 >= layers.size())
+    {
+        throw invalid_argument("FaceDetector: network must contain flattenLayer followed by fc_layer");
+    }
+    shared_ptr<fc_layer> fc = dynamic_pointer_cast<fc_layer>(layers[i + 1]);
+    if (!fc)
+    {
+        throw invalid_argument("FaceDetector: flattenLayer must be followed by fc_layer");
+    }
+
+    // 卷积前缀的总步长，即概率图上相邻两格在输入上的间距
+    vector<int> shape = {3, input_h, input_w};
+    for (const auto& m_layer : features)
+    {
+        spatial_window window;
+        if (!m_layer->get_spatial_window(window))
+        {
+            throw invalid_argument("FaceDetector: layers before flatten must be spatial");
+        }
+        stride_h *= window.stride_h;
+        stride_w *= window.stride_w;
+        shape = m_layer->get_output_shape(shape);
+    }
+
+    // 训练尺寸下最终特征图为 {C, K, K}，全连接层即为覆盖整张特征图的 KxK 卷积
+    if (shape[1] != shape[2])
+    {
+        throw invalid_argument("FaceDetector: final feature map must be square");
+    }
+    classifier = fc->to_conv(shape[0], shape[1]);
+}
+
+Tensor FaceDetector::heatmap(const Tensor& image) const
+{
+    Tensor current = image;
+    for (const auto& m_layer : features)
+    {
+        run_layer(*m_layer, current);
+    }
+
+    Tensor logits;
+    classifier->forward(current, logits);
+
+    // 每个位置上沿通道做 softmax，只保留人脸类别的概率
+    Tensor all_classes;
+    softMax(0).forward(logits, all_classes);
+    int plane = logits.shape[1] * logits.shape[2];
+    Tensor probabilities({logits.shape[1], logits.shape[2]});
+    copy(all_classes.data.begin() + face_class * plane, all_classes.data.begin() + (face_class + 1) * plane,
+         probabilities.data.begin());
+    return probabilities;
+}
+
+namespace
+{
+    using detect_clock = chrono::steady_clock;
+
+    double elapsed_ms(detect_clock::time_point start)
+    {
+        return chrono::duration<double, milli>(detect_clock::now() - start).count();
+    }
+
+    struct PyramidLevel
+    {
+        float scale = 1.0f;
+        vector<Detection> boxes;
+        double ms = 0.0;
+    };
+}
+
+void PyramidStats::print(ostream& os) const
+{
+    os << "pyramid: " << levels << " levels, single-scale " << single_scale_ms << " ms, all levels "
+       << levels_total_ms << " ms (" << (single_scale_ms > 0 ? levels_total_ms / single_scale_ms : 0.0)
+       << "x single-scale, pixel ratio " << pixel_ratio << "), wall " << wall_ms << " ms" << endl;
+}
+
+PyramidDetector::PyramidDetector(const FaceDetector& m_detector, const PyramidConfig& m_config, ThreadPool& m_pool)
+    : detector(m_detector), config(m_config), pool(m_pool)
+{
+    if (config.scale_factor <= 0.0f || config.scale_factor >= 1.0f)
+    {
+        throw invalid_argument("PyramidDetector: scale_factor must be in (0, 1)");
+    }
+}
+
+vector<Detection> PyramidDetector::detect(const cv::Mat& image, PyramidStats* stats) const
+{
+    auto start = detect_clock::now();
+
+    // 各层尺寸：逐层乘以 scale_factor，直到短边放不下一个窗口
+    vector<PyramidLevel> levels;
+    double pixel_sum = 0.0;
+    for (int k = 0; k < config.max_levels; k++)
+    {
+        float scale = pow(config.scale_factor, static_cast<float>(k));
+        int level_h = static_cast<int>(lround(image.rows * scale));
+        int level_w = static_cast<int>(lround(image.cols * scale));
+        if (level_h < detector.get_window_h() || level_w < detector.get_window_w()) break;
+
+        PyramidLevel level;
+        level.scale = static_cast<float>(level_h) / image.rows;
+        levels.push_back(level);
+        pixel_sum += static_cast<double>(level_h) * level_w;
+    }
+
+    // 各任务引用 image 与 levels：必须等所有已提交的任务结束后才能离开本函数，再抛出第一个异常
+    exception_ptr error;
+    vector<future<void>> pending;
+    for (auto& level : levels)
+    {
+        auto task = make_shared<packaged_task<void()>>([this, &image, &level] {
+            auto level_start = detect_clock::now();
+
+            Tensor input;
+            int level_h = static_cast<int>(lround(image.rows * level.scale));
+            int level_w = static_cast<int>(lround(image.cols * level.scale));
+            image_to_tensor(image, level_h, level_w, input);
+            Tensor heat = detector.heatmap(input);
+
+            // 概率图上不低于阈值的 8 邻域局部极大值转换为原图坐标下的框
+            int rows = heat.shape[0], cols = heat.shape[1];
+            for (int i = 0; i < rows; i++)
+            {
+                for (int j = 0; j < cols; j++)
+                {
+                    float p = heat.data[i * cols + j];
+                    if (p < config.threshold) continue;
+
+                    bool is_peak = true;
+                    for (int di = -1; di <= 1 && is_peak; di++)
+                    {
+                        for (int dj = -1; dj <= 1; dj++)
+                        {
+                            int ni = i + di, nj = j + dj;
+                            if ((di || dj) && ni >= 0 && ni < rows && nj >= 0 && nj < cols && heat.data[ni * cols + nj] > p)
+                            {
+                                is_peak = false;
+                                break;
+                            }
+                        }
+                    }
+                    if (!is_peak) continue;
+
+                    Detection box;
+                    box.x = j * detector.get_stride_w() / level.scale;
+                    box.y = i * detector.get_stride_h() / level.scale;
+                    box.width = detector.get_window_w() / level.scale;
+                    box.height = detector.get_window_h() / level.scale;
+                    box.score = p;
+                    level.boxes.push_back(box);
+                }
+            }
+            level.ms = elapsed_ms(level_start);
+        });
+        pending.push_back(task->get_future());
+        try
+        {
+            pool.submit([task] { (*task)(); });
+        }
+        catch (...)
+        {
+            error = current_exception();
+            break;
+        }
+    }
+    for (auto& f : pending)
+    {
+        try
+        {
+            f.get();
+        }
+        catch (...)
+        {
+            if (!error) error = current_exception();
+        }
+    }
+    if (error) rethrow_exception(error);
+
+    vector<Detection> all;
+    for (const auto& level : levels)
+    {
+        all.insert(all.end(), level.boxes.begin(), level.boxes.end());
+    }
+    vector<Detection> result = non_max_suppression(all, config.nms_iou);
+
+    if (stats)
+    {
+        stats->levels = static_cast<int>(levels.size());
+        stats->single_scale_ms = levels.empty() ? 0.0 : levels[0].ms;
+        stats->levels_total_ms = 0.0;
+        for (const auto& level : levels) stats->levels_total_ms += level.ms;
+        stats->pixel_ratio = pixel_sum / (static_cast<double>(image.rows) * image.cols);
+        stats->wall_ms = elapsed_ms(start);
+    }
+    return result;
+}
+
+vector<Detection> non_max_suppression(const vector<Detection>& boxes, float iou_threshold)
+{
+    size_t n = boxes.size();
+    vector<size_t> order(n);
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&boxes](size_t a, size_t b) { return boxes[a].score > boxes[b].score; });
+
+    vector<float> x1(n), y1(n), x2(n), y2(n), area(n), suppressed(n, 0.0f);
+    for (size_t k = 0; k < n; k++)
+    {
+        const Detection& box = boxes[order[k]];
+        x1[k] = box.x;
+        y1[k] = box.y;
+        x2[k] = box.x + box.width;
+        y2[k] = box.y + box.height;
+        area[k] = box.width * box.height;
+    }
+
+    vector<Detection> kept;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (suppressed[i] != 0.0f) continue;
+        kept.push_back(boxes[order[i]]);
+
+        // IoU > t 等价于 inter > t * (area_i + area_j - inter)，避免除法和分支
+        const float bx1 = x1[i], by1 = y1[i], bx2 = x2[i], by2 = y2[i], barea = area[i];
+        for (size_t j = i + 1; j < n; j++)
+        {
+            float w = max(0.0f, min(bx2, x2[j]) - max(bx1, x1[j]));
+            float h = max(0.0f, min(by2, y2[j]) - max(by1, y1[j]));
+            float inter = w * h;
+            float overlap = inter > iou_threshold * (barea + area[j] - inter) ? 1.0f : 0.0f;
+            suppressed[j] = max(suppressed[j], overlap);
+        }
+    }
+    return kept;
+}
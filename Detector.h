@@ -0,0 +1,89 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef DETECTOR_H
+#define DETECTOR_H
+
+#include "CNN.h"
+#include "ThreadPool.h"
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// 全卷积滑窗检测：flatten 之前的卷积前缀原样复用，其后的 fc_layer 改写为与最终特征图同尺寸的卷积，
+// 网络对任意尺寸的图像只运行一次，所有窗口共享卷积计算，输出稠密的人脸概率图。
+// 概率图 (i, j) 对应左上角为 (i * stride, j * stride)、边长为 window 的输入窗口；
+// 与逐窗口调用 CNN::predict 相比，只有贴着图像边界的窗口会看到零填充，内部窗口看到的是真实邻域像素。
+class FaceDetector
+{
+private:
+    vector<shared_ptr<layer>> features;   // flatten 之前的卷积前缀
+    shared_ptr<Conv> classifier;          // 由 fc_layer 改写而来的卷积
+    int stride_h = 1, stride_w = 1;
+    int window_h = 0, window_w = 0;
+    int face_class = 0;                   // 输出中表示人脸的类别下标
+
+public:
+    // cnn 需为 "卷积前缀 -> flattenLayer -> fc_layer [-> softMax]" 结构，input_h/input_w 为训练时的输入尺寸
+    FaceDetector(const CNN& cnn, int input_h = 128, int input_w = 128);
+
+    // image 为任意尺寸 (不小于窗口) 的 CHW 图像，返回 {H', W'} 的人脸概率图
+    Tensor heatmap(const Tensor& image) const;
+
+    int get_stride_h() const { return stride_h; }
+    int get_stride_w() const { return stride_w; }
+    int get_window_h() const { return window_h; }
+    int get_window_w() const { return window_w; }
+};
+
+// 原图坐标下的检测框
+struct Detection
+{
+    float x = 0.0f, y = 0.0f, width = 0.0f, height = 0.0f;
+    float score = 0.0f;
+};
+
+struct PyramidConfig
+{
+    float scale_factor = 0.8f;  // 相邻两层的缩放比例
+    int max_levels = 16;
+    float threshold = 0.9f;     // 人脸概率阈值
+    float nms_iou = 0.3f;       // 非极大值抑制的 IoU 阈值
+};
+
+// 多尺度检测的耗时统计，single_scale_ms 为原尺寸一层的耗时
+struct PyramidStats
+{
+    int levels = 0;
+    double single_scale_ms = 0.0;
+    double levels_total_ms = 0.0;   // 各层耗时之和 (计算量)
+    double wall_ms = 0.0;           // 含缩放、并行执行和 NMS 的总耗时
+    double pixel_ratio = 0.0;       // 各层像素数之和 / 原图像素数
+
+    void print(ostream& os) const;
+};
+
+// 图像金字塔检测：用预处理路径生成逐层缩小的输入，各层在线程池上并行运行 FaceDetector，
+// 概率图的局部极大值转换为原图坐标下的框，最后合并做非极大值抑制。
+// 不要在同一线程池的工作线程里调用 detect，否则会因等待自身任务而死锁
+class PyramidDetector
+{
+private:
+    const FaceDetector& detector;
+    PyramidConfig config;
+    ThreadPool& pool;
+
+public:
+    PyramidDetector(const FaceDetector& m_detector, const PyramidConfig& m_config, ThreadPool& m_pool = ThreadPool::shared());
+
+    // image 为 8 位 BGR 图像
+    vector<Detection> detect(const cv::Mat& image, PyramidStats* stats = nullptr) const;
+};
+
+// 按分数从高到低保留框，并抑制与已保留框 IoU 超过阈值的框。
+// 坐标按列存放 (SoA)，内层循环无分支，可被编译器向量化
+vector<Detection> non_max_suppression(const vector<Detection>& boxes, float iou_threshold);
+
+#endif //DETECTOR_H
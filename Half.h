@@ -0,0 +1,70 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef HALF_H
+#define HALF_H
+
+#include <cstdint>
+#include <cstring>
+
+// IEEE 754 半精度 (fp16) 与 float 之间的转换，不依赖 F16C 指令
+
+inline float half_to_float(uint16_t h)
+{
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1F;
+    uint32_t mantissa = h & 0x3FF;
+
+    if (exponent == 0)
+    {
+        // 零或非规格化数: mantissa * 2^-24
+        float value = mantissa * (1.0f / 16777216.0f);
+        return sign ? -value : value;
+    }
+
+    uint32_t bits;
+    if (exponent == 31) bits = sign | 0x7F800000 | (mantissa << 13);    // inf / nan
+    else bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+// 就近舍入 (ties-to-even)，超出范围的值变为 inf
+inline uint16_t float_to_half(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t abs_bits = bits & 0x7FFFFFFF;
+
+    if (abs_bits >= 0x7F800000)
+    {
+        return static_cast<uint16_t>(sign | 0x7C00 | (abs_bits > 0x7F800000 ? 0x200 : 0));
+    }
+    if (abs_bits >= 0x477FF000)
+    {
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+    if (abs_bits < 0x38800000)
+    {
+        // 结果为非规格化数或零
+        if (abs_bits < 0x33000000) return static_cast<uint16_t>(sign);
+        uint32_t mantissa = (abs_bits & 0x7FFFFF) | 0x800000;
+        uint32_t shift = 126 - (abs_bits >> 23);
+        uint32_t result = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (result & 1))) result++;
+        return static_cast<uint16_t>(sign | result);
+    }
+
+    uint32_t result = (abs_bits >> 13) - (112 << 10);
+    uint32_t remainder = abs_bits & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (result & 1))) result++;
+    return static_cast<uint16_t>(sign | result);
+}
+
+#endif //HALF_H
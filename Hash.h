@@ -0,0 +1,32 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// 128 位内容哈希，用作缓存键
+struct Hash128
+{
+    uint64_t low = 0;
+    uint64_t high = 0;
+
+    bool operator==(const Hash128& other) const { return low == other.low && high == other.high; }
+    bool operator!=(const Hash128& other) const { return !(*this == other); }
+};
+
+// 供 unordered_map 使用：128 位哈希本身已均匀分布，把高低两半折叠为 size_t 即可
+struct Hash128Hasher
+{
+    size_t operator()(const Hash128& key) const { return static_cast<size_t>(key.low ^ (key.high * 0x9E3779B97F4A7C15ull)); }
+};
+
+// MurmurHash3 x64 128 位版本，每次处理 16 字节，约数 GB/s
+Hash128 hash128(const void* data, size_t bytes, uint64_t seed = 0);
+
+#endif //HASH_H
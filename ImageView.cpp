@@ -0,0 +1,84 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "ImageView.h"
+#include <stdexcept>
+
+using namespace std;
+
+ImageView::ImageView(const void* m_data, PixelType m_dtype, PixelLayout m_layout, int m_channels, int m_height, int m_width)
+    : data(m_data), dtype(m_dtype), layout(m_layout), channels(m_channels), height(m_height), width(m_width)
+{
+    if (dtype != PixelType::U8) scale = 1.0f;
+
+    ptrdiff_t elem = element_size();
+    if (layout == PixelLayout::HWC)
+    {
+        stride_c = elem;
+        stride_w = elem * channels;
+        stride_h = stride_w * width;
+    }
+    else
+    {
+        stride_w = elem;
+        stride_h = elem * width;
+        stride_c = stride_h * height;
+    }
+}
+
+void ImageView::validate() const
+{
+    if (data == nullptr)
+    {
+        throw invalid_argument("ImageView: data pointer is null");
+    }
+    if (channels <= 0 || height <= 0 || width <= 0)
+    {
+        throw invalid_argument("ImageView: dimensions must be greater than zero");
+    }
+    if (stride_c <= 0 || stride_h <= 0 || stride_w <= 0)
+    {
+        throw invalid_argument("ImageView: strides must be greater than zero");
+    }
+}
+
+void ImageView::read_row(int c, int h, int x0, int count, float* dst) const
+{
+    const uint8_t* row = static_cast<const uint8_t*>(data) + c * stride_c + h * stride_h + x0 * stride_w;
+    if (dtype == PixelType::U8)
+    {
+        for (int w = 0; w < count; w++)
+        {
+            dst[w] = row[w * stride_w] * scale;
+        }
+    }
+    else if (dtype == PixelType::F16)
+    {
+        for (int w = 0; w < count; w++)
+        {
+            dst[w] = half_to_float(*reinterpret_cast<const uint16_t*>(row + w * stride_w)) * scale;
+        }
+    }
+    else
+    {
+        for (int w = 0; w < count; w++)
+        {
+            dst[w] = *reinterpret_cast<const float*>(row + w * stride_w) * scale;
+        }
+    }
+}
+
+Tensor ImageView::to_tensor() const
+{
+    validate();
+    Tensor result(shape());
+    for (int c = 0; c < channels; c++)
+    {
+        for (int h = 0; h < height; h++)
+        {
+            read_row(c, h, result.data.data() + (c * height + h) * width);
+        }
+    }
+    return result;
+}
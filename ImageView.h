@@ -0,0 +1,77 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef IMAGE_VIEW_H
+#define IMAGE_VIEW_H
+
+#include "Tensor.h"
+#include "Half.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// 外部缓冲区中单个元素的数据类型
+enum class PixelType
+{
+    U8,
+    F16,
+    F32
+};
+
+// 外部缓冲区的排布方式：平面 (CHW) 或交错 (HWC，OpenCV 默认)
+enum class PixelLayout
+{
+    CHW,
+    HWC
+};
+
+// 对调用方持有的图像缓冲区的只读视图，不拷贝、不拥有数据。
+// 通道顺序需与 CNN::load_image_as_tensor 一致 (OpenCV 的 BGR)。
+struct ImageView
+{
+    const void* data = nullptr;
+    PixelType dtype = PixelType::U8;
+    PixelLayout layout = PixelLayout::HWC;
+    int channels = 0;
+    int height = 0;
+    int width = 0;
+    // 以字节为单位的步长，构造时按紧密排列推导，可在之后改写 (例如带行填充的共享内存帧)
+    ptrdiff_t stride_c = 0;
+    ptrdiff_t stride_h = 0;
+    ptrdiff_t stride_w = 0;
+    // 读取时乘上的系数，U8 默认归一化到 [0, 1]，与 load_image_as_tensor 保持一致
+    float scale = 1.0f / 255.0f;
+
+    ImageView() = default;
+    ImageView(const void* m_data, PixelType m_dtype, PixelLayout m_layout, int m_channels, int m_height, int m_width);
+
+    int element_size() const { return dtype == PixelType::U8 ? 1 : (dtype == PixelType::F16 ? 2 : 4); }
+
+    vector<int> shape() const { return {channels, height, width}; }
+
+    // 读取 (c, h, w) 处的元素并转换为 float
+    float at(int c, int h, int w) const
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(data) + c * stride_c + h * stride_h + w * stride_w;
+        if (dtype == PixelType::U8) return *p * scale;
+        if (dtype == PixelType::F16) return half_to_float(*reinterpret_cast<const uint16_t*>(p)) * scale;
+        return *reinterpret_cast<const float*>(p) * scale;
+    }
+
+    // 把第 h 行、第 c 通道的 width 个元素转换后写入 dst
+    void read_row(int c, int h, float* dst) const { read_row(c, h, 0, width, dst); }
+
+    // 只读取第 h 行中从 x0 开始的 count 个元素
+    void read_row(int c, int h, int x0, int count, float* dst) const;
+
+    // 检查指针、尺寸和步长是否合法，不合法时抛出 invalid_argument
+    void validate() const;
+
+    // 拷贝为 CHW 的 Tensor (仅在第一层无法直接读取视图时使用)
+    Tensor to_tensor() const;
+};
+
+#endif //IMAGE_VIEW_H
@@ -0,0 +1,38 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "InferenceTasks.h"
+#include "Preprocess.h"
+
+using namespace std;
+
+PoolAwaitable<cv::Mat> co_read_image(ThreadPool& pool, string path, int target_h, int target_w)
+{
+    return PoolAwaitable<cv::Mat>(pool, [path = std::move(path), target_h, target_w] {
+        return read_image(path, target_h, target_w);
+    });
+}
+
+PoolAwaitable<Tensor> co_preprocess(ThreadPool& pool, cv::Mat image, int target_h, int target_w)
+{
+    return PoolAwaitable<Tensor>(pool, [image = std::move(image), target_h, target_w] {
+        Tensor output;
+        image_to_tensor(image, target_h, target_w, output);
+        return output;
+    });
+}
+
+PoolAwaitable<Tensor> co_predict(ThreadPool& pool, CNN& cnn, Tensor input)
+{
+    return PoolAwaitable<Tensor>(pool, [&cnn, input = std::move(input)]() mutable {
+        return cnn.predict(input);
+    });
+}
+
+Task<Tensor> classify(CNN& cnn, string path, ThreadPool& pool, int input_h, int input_w)
+{
+    cv::Mat image = co_await co_read_image(pool, std::move(path), input_h, input_w);
+    Tensor input = co_await co_preprocess(pool, std::move(image), input_h, input_w);
+    co_return co_await co_predict(pool, cnn, std::move(input));
+}
@@ -0,0 +1,29 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef INFERENCE_TASKS_H
+#define INFERENCE_TASKS_H
+
+#include "CNN.h"
+#include "Coroutine.h"
+#include <string>
+
+using namespace std;
+
+// 推理各阶段的 awaitable 包装：co_await 时协程挂起，工作在线程池上完成后再恢复，
+// 服务线程不会阻塞，同时挂起的请求只占各自的协程帧，不占线程
+
+// 以降低的分辨率读取并解码图像 (read_image)
+PoolAwaitable<cv::Mat> co_read_image(ThreadPool& pool, string path, int target_h, int target_w);
+
+// 缩放并转换为 CHW 张量 (image_to_tensor)
+PoolAwaitable<Tensor> co_preprocess(ThreadPool& pool, cv::Mat image, int target_h, int target_w);
+
+// CNN::predict
+PoolAwaitable<Tensor> co_predict(ThreadPool& pool, CNN& cnn, Tensor input);
+
+// 完整的分类请求：读取 -> 预处理 -> 推理，返回网络输出
+Task<Tensor> classify(CNN& cnn, string path, ThreadPool& pool, int input_h = 128, int input_w = 128);
+
+#endif //INFERENCE_TASKS_H
@@ -0,0 +1,91 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "Layout.h"
+#include <stdexcept>
+
+using namespace std;
+
+Tensor to_blocked(const Tensor& input)
+{
+    if (input.layout == TensorLayout::CHWc) return input;
+    if (input.layout != TensorLayout::CHW) return to_blocked(to_planar(input));
+    if (input.shape.size() != 3 || !blockable(input.shape[0]))
+    {
+        throw invalid_argument("to_blocked: expects [C, H, W] with C a multiple of " + to_string(channel_block));
+    }
+
+    int blocks = input.shape[0] / channel_block;
+    int plane = input.shape[1] * input.shape[2];
+    Tensor output(input.shape);
+    output.layout = TensorLayout::CHWc;
+    for (int b = 0; b < blocks; b++)
+    {
+        const float* src = input.data.data() + static_cast<size_t>(b) * channel_block * plane;
+        float* dst = output.data.data() + static_cast<size_t>(b) * channel_block * plane;
+        for (int p = 0; p < plane; p++)
+        {
+            for (int v = 0; v < channel_block; v++) dst[p * channel_block + v] = src[v * plane + p];
+        }
+    }
+    return output;
+}
+
+Tensor to_channels_last(const Tensor& input)
+{
+    if (input.layout == TensorLayout::HWC) return input;
+    if (input.layout != TensorLayout::CHW) return to_channels_last(to_planar(input));
+    if (input.shape.size() != 3)
+    {
+        throw invalid_argument("to_channels_last: expects [C, H, W]");
+    }
+
+    int channels = input.shape[0];
+    int plane = input.shape[1] * input.shape[2];
+    Tensor output(input.shape);
+    output.layout = TensorLayout::HWC;
+    for (int c = 0; c < channels; c++)
+    {
+        for (int p = 0; p < plane; p++) output.data[static_cast<size_t>(p) * channels + c] = input.data[static_cast<size_t>(c) * plane + p];
+    }
+    return output;
+}
+
+Tensor to_planar(const Tensor& input)
+{
+    if (input.layout == TensorLayout::CHW) return input;
+    if (input.layout == TensorLayout::HWC)
+    {
+        if (input.shape.size() != 3)
+        {
+            throw invalid_argument("to_planar: malformed HWC tensor");
+        }
+        int channels = input.shape[0];
+        int plane = input.shape[1] * input.shape[2];
+        Tensor output(input.shape);
+        for (int p = 0; p < plane; p++)
+        {
+            for (int c = 0; c < channels; c++) output.data[static_cast<size_t>(c) * plane + p] = input.data[static_cast<size_t>(p) * channels + c];
+        }
+        return output;
+    }
+    if (input.shape.size() != 3 || !blockable(input.shape[0]))
+    {
+        throw invalid_argument("to_planar: malformed CHWc tensor");
+    }
+
+    int blocks = input.shape[0] / channel_block;
+    int plane = input.shape[1] * input.shape[2];
+    Tensor output(input.shape);
+    for (int b = 0; b < blocks; b++)
+    {
+        const float* src = input.data.data() + static_cast<size_t>(b) * channel_block * plane;
+        float* dst = output.data.data() + static_cast<size_t>(b) * channel_block * plane;
+        for (int v = 0; v < channel_block; v++)
+        {
+            for (int p = 0; p < plane; p++) dst[v * plane + p] = src[p * channel_block + v];
+        }
+    }
+    return output;
+}
@@ -0,0 +1,30 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include "Tensor.h"
+
+// CHWc 的通道块大小：AVX-512 下一个块正好是一个 16 路寄存器，其余目标 (AVX2 / SSE2) 取 8。
+// 块内是同一像素的相邻通道，卷积对一个块的累加可以整块放在寄存器里
+#if defined(__AVX512F__)
+constexpr int channel_block = 16;
+#else
+constexpr int channel_block = 8;
+#endif
+
+// 通道数为 channel_block 的整数倍时才使用 CHWc (不做通道填充)
+inline bool blockable(int channels)
+{
+    return channels > 0 && channels % channel_block == 0;
+}
+
+// 布局转换，只在图的边界使用：CHW 输入 -> CHWc，以及 flatten / 网络输出前还原为 CHW。
+// 输入已是目标布局时直接拷贝，其余布局之间经由 CHW 转换
+Tensor to_blocked(const Tensor& input);
+Tensor to_channels_last(const Tensor& input);
+Tensor to_planar(const Tensor& input);
+
+#endif //LAYOUT_H
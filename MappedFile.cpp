@@ -0,0 +1,105 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "MappedFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const string& path)
+{
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw runtime_error("MappedFile: cannot open " + path);
+    }
+    file_handle = file;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+    {
+        close();
+        throw runtime_error("MappedFile: empty or unreadable file " + path);
+    }
+    length = static_cast<size_t>(file_size.QuadPart);
+
+    mapping_handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle == nullptr)
+    {
+        close();
+        throw runtime_error("MappedFile: CreateFileMapping failed for " + path);
+    }
+    base = static_cast<const unsigned char*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+    if (base == nullptr)
+    {
+        close();
+        throw runtime_error("MappedFile: MapViewOfFile failed for " + path);
+    }
+}
+
+void MappedFile::close()
+{
+    if (base) UnmapViewOfFile(base);
+    if (mapping_handle) CloseHandle(mapping_handle);
+    if (file_handle) CloseHandle(file_handle);
+    base = nullptr;
+    mapping_handle = nullptr;
+    file_handle = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile(const string& path)
+{
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw runtime_error("MappedFile: cannot open " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close();
+        throw runtime_error("MappedFile: empty or unreadable file " + path);
+    }
+    length = static_cast<size_t>(st.st_size);
+
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED)
+    {
+        close();
+        throw runtime_error("MappedFile: mmap failed for " + path);
+    }
+    base = static_cast<const unsigned char*>(mapped);
+}
+
+void MappedFile::close()
+{
+    if (base) munmap(const_cast<unsigned char*>(base), length);
+    if (fd >= 0) ::close(fd);
+    base = nullptr;
+    fd = -1;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
@@ -0,0 +1,39 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+// 只读的文件内存映射 (Windows: CreateFileMapping，其他平台: mmap)
+class MappedFile
+{
+private:
+    const unsigned char* base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* file_handle = nullptr;
+    void* mapping_handle = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    void close();
+
+public:
+    explicit MappedFile(const string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return base; }
+    size_t size() const { return length; }
+
+    ~MappedFile();
+};
+
+#endif //MAPPED_FILE_H
@@ -0,0 +1,115 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "ModelRegistry.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+Tensor ServedModel::predict(Tensor& input) const
+{
+    shared_ptr<const LoadedModel> model = get();
+    if (!model)
+    {
+        throw runtime_error("ServedModel: no model has been published");
+    }
+    return model->cnn->predict(input);
+}
+
+shared_ptr<const LoadedModel> ServedModel::swap(shared_ptr<const LoadedModel> next)
+{
+    shared_ptr<const LoadedModel> previous = current.exchange(std::move(next), memory_order_acq_rel);
+    if (previous)
+    {
+        lock_guard<mutex> lock(retired_mtx);
+        retired.erase(remove_if(retired.begin(), retired.end(), [](const weak_ptr<CNN>& w) { return w.expired(); }),
+                      retired.end());
+        retired.push_back(previous->cnn);
+    }
+    return previous;
+}
+
+size_t ServedModel::draining() const
+{
+    lock_guard<mutex> lock(retired_mtx);
+    return static_cast<size_t>(count_if(retired.begin(), retired.end(), [](const weak_ptr<CNN>& w) { return !w.expired(); }));
+}
+
+ModelRegistry::ModelRegistry(vector<int> m_warmup_shape, int m_warmup_runs)
+    : warmup_shape(std::move(m_warmup_shape)), warmup_runs(m_warmup_runs)
+{
+}
+
+void ModelRegistry::register_model(const string& name, int version, ModelFactory factory)
+{
+    if (!factory)
+    {
+        throw invalid_argument("ModelRegistry: empty factory for " + name);
+    }
+    lock_guard<mutex> lock(mtx);
+    factories[name][version] = std::move(factory);
+}
+
+vector<pair<string, int>> ModelRegistry::list() const
+{
+    lock_guard<mutex> lock(mtx);
+    vector<pair<string, int>> result;
+    for (const auto& [name, versions] : factories)
+    {
+        for (const auto& entry : versions) result.emplace_back(name, entry.first);
+    }
+    return result;
+}
+
+shared_ptr<CNN> ModelRegistry::load(const string& name, int version) const
+{
+    ModelFactory factory;
+    {
+        lock_guard<mutex> lock(mtx);
+        auto by_name = factories.find(name);
+        if (by_name == factories.end() || !by_name->second.count(version))
+        {
+            throw invalid_argument("ModelRegistry: unknown model " + name + " v" + to_string(version));
+        }
+        factory = by_name->second.at(version);
+    }
+
+    shared_ptr<CNN> cnn = factory();
+    if (!cnn)
+    {
+        throw runtime_error("ModelRegistry: factory returned no model for " + name + " v" + to_string(version));
+    }
+
+    // 预热：让各层完成首次分配并检查输出是否有效，之后才允许上线
+    Tensor input(warmup_shape);
+    for (int i = 0; i < warmup_runs; i++)
+    {
+        Tensor output = cnn->predict(input);
+        bool valid = output.size() > 0 && all_of(output.data.begin(), output.data.end(), [](float v) { return isfinite(v); });
+        if (!valid)
+        {
+            throw runtime_error("ModelRegistry: warm-up of " + name + " v" + to_string(version) + " produced invalid output");
+        }
+    }
+    return cnn;
+}
+
+void ModelRegistry::publish(const string& name, int version)
+{
+    auto next = make_shared<LoadedModel>();
+    next->name = name;
+    next->version = version;
+    next->cnn = load(name, version);
+    served(name).swap(std::move(next));
+}
+
+ServedModel& ModelRegistry::served(const string& name)
+{
+    lock_guard<mutex> lock(mtx);
+    unique_ptr<ServedModel>& slot = served_models[name];
+    if (!slot) slot = make_unique<ServedModel>();
+    return *slot;
+}
@@ -0,0 +1,80 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef MODEL_REGISTRY_H
+#define MODEL_REGISTRY_H
+
+#include "CNN.h"
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// 搭建一个模型实例 (分配层并载入权重)
+using ModelFactory = function<shared_ptr<CNN>()>;
+
+// 已上线的一个具体版本
+struct LoadedModel
+{
+    string name;
+    int version = 0;
+    shared_ptr<CNN> cnn;
+};
+
+// 某个名称下当前对外服务的模型。请求路径只做一次原子 shared_ptr 读取，不加锁；
+// 请求持有的 shared_ptr 让旧版本在切换后继续可用，最后一个在途请求结束时旧模型自动释放
+class ServedModel
+{
+private:
+    atomic<shared_ptr<const LoadedModel>> current;
+    mutable mutex retired_mtx;
+    vector<weak_ptr<CNN>> retired;   // 已下线但可能仍被在途请求使用的版本
+
+public:
+    shared_ptr<const LoadedModel> get() const { return current.load(memory_order_acquire); }
+
+    // 取当前版本并推理；切换发生在请求中途也不影响本次请求
+    Tensor predict(Tensor& input) const;
+
+    // 换上 next，返回被替换的版本 (可能为空)
+    shared_ptr<const LoadedModel> swap(shared_ptr<const LoadedModel> next);
+
+    // 已下线但仍有在途请求引用、尚未释放的版本数
+    size_t draining() const;
+};
+
+// 按名称与版本注册模型工厂；publish 先在后台构建并预热新版本，成功后才原子地切换，
+// 构建或预热失败时抛出异常，线上版本保持不变
+class ModelRegistry
+{
+private:
+    mutable mutex mtx;   // 只保护注册表本身，不在请求路径上
+    map<string, map<int, ModelFactory>> factories;
+    map<string, unique_ptr<ServedModel>> served_models;
+    vector<int> warmup_shape;
+    int warmup_runs;
+
+public:
+    explicit ModelRegistry(vector<int> m_warmup_shape = {3, 128, 128}, int m_warmup_runs = 2);
+
+    void register_model(const string& name, int version, ModelFactory factory);
+    vector<pair<string, int>> list() const;
+
+    // 构建并预热一个版本，不影响线上服务
+    shared_ptr<CNN> load(const string& name, int version) const;
+
+    // 构建、预热并切换为 name 的线上版本
+    void publish(const string& name, int version);
+
+    // 请求方应在启动时取一次并保存引用，之后的 get/predict 不再经过注册表的锁
+    ServedModel& served(const string& name);
+};
+
+#endif //MODEL_REGISTRY_H
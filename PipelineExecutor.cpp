@@ -0,0 +1,275 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "PipelineExecutor.h"
+#include "BoundedQueue.h"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+    using pipeline_clock = chrono::steady_clock;
+
+    double elapsed_ms(pipeline_clock::time_point start)
+    {
+        return chrono::duration<double, milli>(pipeline_clock::now() - start).count();
+    }
+
+    // 把当前线程绑定到 cores 中的核，平台不支持时返回 false
+    bool pin_current_thread(const vector<int>& cores)
+    {
+        if (cores.empty()) return false;
+#ifdef _WIN32
+        DWORD_PTR mask = 0;
+        for (int core : cores)
+        {
+            if (core >= 0 && core < static_cast<int>(sizeof(DWORD_PTR) * 8)) mask |= DWORD_PTR(1) << core;
+        }
+        return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int core : cores)
+        {
+            if (core >= 0 && core < CPU_SETSIZE) CPU_SET(core, &set);
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        return false;
+#endif
+    }
+
+    // 相邻两级之间的双缓冲：上一级写一个缓冲区时，下一级读另一个
+    struct Handoff
+    {
+        Tensor buffers[2];
+        size_t items[2] = {0, 0};
+        BoundedQueue<int> free_slots{2};
+        BoundedQueue<int> ready_slots{2};
+
+        Handoff()
+        {
+            free_slots.push(0);
+            free_slots.push(1);
+        }
+
+        void close()
+        {
+            free_slots.close();
+            ready_slots.close();
+        }
+    };
+}
+
+double PipelineStats::imbalance() const
+{
+    if (stage_cost_ms.empty()) return 1.0;
+    double total = accumulate(stage_cost_ms.begin(), stage_cost_ms.end(), 0.0);
+    double slowest = *max_element(stage_cost_ms.begin(), stage_cost_ms.end());
+    return total > 0 ? slowest / (total / stage_cost_ms.size()) : 1.0;
+}
+
+double PipelineStats::bubble_fraction() const
+{
+    if (stage_busy_ms.empty() || wall_ms <= 0) return 0.0;
+    double busy = accumulate(stage_busy_ms.begin(), stage_busy_ms.end(), 0.0);
+    return 1.0 - busy / (stage_busy_ms.size() * wall_ms);
+}
+
+void PipelineStats::print(ostream& os) const
+{
+    os << "pipeline: " << stage_cost_ms.size() << " stages, " << items << " items in " << wall_ms << " ms, "
+       << (wall_ms > 0 ? items * 1000.0 / wall_ms : 0.0) << " items/s\n";
+    for (size_t i = 0; i < stage_cost_ms.size(); i++)
+    {
+        os << "  stage " << i << ": cost " << stage_cost_ms[i] << " ms, busy " << stage_busy_ms[i] << " ms"
+           << (pinned[i] ? " (pinned)" : "") << "\n";
+    }
+    os << "imbalance (slowest / mean) " << imbalance() << ", bubble fraction " << bubble_fraction() * 100.0 << "%" << endl;
+}
+
+PipelineExecutor::PipelineExecutor(CNN& m_cnn, const Tensor& sample, const PipelineConfig& m_config)
+    : cnn(m_cnn), config(m_config)
+{
+    const vector<shared_ptr<layer>>& layers = cnn.get_layers();
+    size_t n = layers.size();
+    if (n == 0)
+    {
+        throw invalid_argument("PipelineExecutor: network has no layers");
+    }
+    if (config.calibration_runs <= 0)
+    {
+        throw invalid_argument("PipelineExecutor: calibration_runs must be greater than zero");
+    }
+
+    size_t stages = config.stages > 0 ? static_cast<size_t>(config.stages) : max<size_t>(1, thread::hardware_concurrency());
+    stages = min(stages, n);
+
+    // 1. 标定：逐层计时，取多次中的最小值
+    vector<double> cost(n, numeric_limits<double>::max());
+    for (int r = 0; r < config.calibration_runs; r++)
+    {
+        Tensor current = sample;
+        for (size_t l = 0; l < n; l++)
+        {
+            Tensor next;
+            auto start = pipeline_clock::now();
+            layers[l]->forward(current, next);
+            cost[l] = min(cost[l], elapsed_ms(start));
+            current = std::move(next);
+        }
+    }
+
+    // 2. 切分：动态规划求把 n 层分成 stages 段连续区间时最慢一段的最小耗时
+    vector<double> prefix(n + 1, 0.0);
+    for (size_t l = 0; l < n; l++) prefix[l + 1] = prefix[l] + cost[l];
+
+    const double inf = numeric_limits<double>::max();
+    vector<vector<double>> best(stages + 1, vector<double>(n + 1, inf));
+    vector<vector<size_t>> split(stages + 1, vector<size_t>(n + 1, 0));
+    best[0][0] = 0.0;
+    for (size_t s = 1; s <= stages; s++)
+    {
+        for (size_t i = s; i <= n; i++)
+        {
+            for (size_t j = s - 1; j < i; j++)
+            {
+                if (best[s - 1][j] == inf) continue;
+                double candidate = max(best[s - 1][j], prefix[i] - prefix[j]);
+                if (candidate < best[s][i])
+                {
+                    best[s][i] = candidate;
+                    split[s][i] = j;
+                }
+            }
+        }
+    }
+
+    stage_begin.assign(stages + 1, n);
+    for (size_t s = stages, i = n; s > 0; s--)
+    {
+        i = split[s][i];
+        stage_begin[s - 1] = i;
+    }
+    for (size_t s = 0; s < stages; s++)
+    {
+        stage_cost.push_back(prefix[stage_begin[s + 1]] - prefix[stage_begin[s]]);
+    }
+}
+
+PipelineStats PipelineExecutor::run(const vector<Tensor>& inputs, const function<void(size_t, const Tensor&)>& on_output)
+{
+    const vector<shared_ptr<layer>>& layers = cnn.get_layers();
+    size_t stages = stage_count();
+    unsigned cores = max(1u, thread::hardware_concurrency());
+
+    PipelineStats stats;
+    stats.items = inputs.size();
+    stats.stage_cost_ms = stage_cost;
+    stats.stage_busy_ms.assign(stages, 0.0);
+    stats.pinned.assign(stages, 0);
+
+    // handoffs[s] 连接第 s 级与第 s+1 级
+    vector<unique_ptr<Handoff>> handoffs;
+    for (size_t s = 0; s + 1 < stages; s++) handoffs.push_back(make_unique<Handoff>());
+
+    exception_ptr failure;
+    mutex failure_mtx;
+    auto fail = [&](exception_ptr error) {
+        lock_guard<mutex> lock(failure_mtx);
+        if (!failure) failure = error;
+        for (auto& handoff : handoffs) handoff->close();
+    };
+
+    auto stage_loop = [&](size_t s) {
+        if (config.pin_threads)
+        {
+            vector<int> group = s < config.core_groups.size() ? config.core_groups[s] : vector<int>{static_cast<int>(s % cores)};
+            stats.pinned[s] = pin_current_thread(group);
+        }
+
+        Handoff* in = s > 0 ? handoffs[s - 1].get() : nullptr;
+        Handoff* out = s + 1 < stages ? handoffs[s].get() : nullptr;
+        size_t first = stage_begin[s], last = stage_begin[s + 1];
+        vector<Tensor> scratch(last - first);
+        Tensor result;
+
+        try
+        {
+            for (size_t item = 0;; item++)
+            {
+                // 取本级输入
+                int in_slot = -1;
+                const Tensor* source = nullptr;
+                if (in)
+                {
+                    if (!in->ready_slots.pop(in_slot)) break;
+                    source = &in->buffers[in_slot];
+                    item = in->items[in_slot];
+                }
+                else
+                {
+                    if (item >= inputs.size()) break;
+                    source = &inputs[item];
+                }
+
+                int out_slot = -1;
+                if (out && !out->free_slots.pop(out_slot)) break;
+                Tensor& target = out ? out->buffers[out_slot] : result;
+
+                auto start = pipeline_clock::now();
+                const Tensor* current = source;
+                for (size_t l = first; l < last; l++)
+                {
+                    Tensor& next = l + 1 == last ? target : scratch[l - first];
+                    layers[l]->forward(*current, next);
+                    current = &next;
+                }
+                stats.stage_busy_ms[s] += elapsed_ms(start);
+
+                // 输入缓冲区用完即归还上一级，输出交给下一级
+                if (in) in->free_slots.push(in_slot);
+                if (out)
+                {
+                    out->items[out_slot] = item;
+                    out->ready_slots.push(out_slot);
+                }
+                else if (on_output)
+                {
+                    on_output(item, result);
+                }
+            }
+        }
+        catch (...)
+        {
+            fail(current_exception());
+        }
+        if (out) out->ready_slots.close();
+    };
+
+    auto start = pipeline_clock::now();
+    vector<thread> workers;
+    for (size_t s = 0; s < stages; s++) workers.emplace_back(stage_loop, s);
+    for (auto& worker : workers) worker.join();
+    stats.wall_ms = elapsed_ms(start);
+
+    if (failure) rethrow_exception(failure);
+    return stats;
+}
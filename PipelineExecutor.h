@@ -0,0 +1,61 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef PIPELINE_EXECUTOR_H
+#define PIPELINE_EXECUTOR_H
+
+#include "CNN.h"
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+using namespace std;
+
+struct PipelineConfig
+{
+    int stages = 0;                 // 流水线级数，0 表示取硬件并发数与层数中较小者
+    bool pin_threads = true;        // 是否把每一级绑定到自己的核 (或核组)
+    vector<vector<int>> core_groups;// 第 i 级绑定的核编号；为空时第 i 级绑定到第 i 个核
+    int calibration_runs = 3;       // 测量各层耗时的次数，取最小值
+};
+
+struct PipelineStats
+{
+    size_t items = 0;
+    double wall_ms = 0.0;
+    vector<double> stage_cost_ms;   // 标定得到的各级单次耗时
+    vector<double> stage_busy_ms;   // 运行期间各级实际计算耗时
+    vector<char> pinned;            // 各级线程是否绑核成功 (不用 vector<bool>：各级线程同时写入，按位压缩的元素共享同一个字)
+
+    // 最慢一级与平均值之比，1 表示完全均衡
+    double imbalance() const;
+    // 流水线空泡比例：1 - 各级忙碌时间之和 / (级数 x 总耗时)
+    double bubble_fraction() const;
+    void print(ostream& os) const;
+};
+
+// 层流水线并行：把 CNN 的层按标定耗时切分为若干连续的级，每级一个线程并绑定到各自的核，
+// 相邻两级之间用双缓冲的 Tensor 交接，第 k 级处理第 i 个输入时第 k+1 级可同时处理第 i-1 个输入。
+// 单个输入的延迟不变，稳定流量下吞吐接近 1 / 最慢一级的耗时
+class PipelineExecutor
+{
+private:
+    CNN& cnn;
+    PipelineConfig config;
+    vector<size_t> stage_begin;     // 第 i 级负责 [stage_begin[i], stage_begin[i + 1]) 层
+    vector<double> stage_cost;
+
+public:
+    // sample 为一个代表性输入，用于测量各层耗时并确定切分
+    PipelineExecutor(CNN& m_cnn, const Tensor& sample, const PipelineConfig& m_config = PipelineConfig());
+
+    size_t stage_count() const { return stage_cost.size(); }
+    size_t stage_first_layer(size_t stage) const { return stage_begin[stage]; }
+
+    // 依次让 inputs 流过流水线，on_output 在最后一级的线程上按输入顺序调用
+    PipelineStats run(const vector<Tensor>& inputs, const function<void(size_t, const Tensor&)>& on_output);
+};
+
+#endif //PIPELINE_EXECUTOR_H
@@ -0,0 +1,215 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "Pooling.h"
+#include "FastMath.h"
+#include "Layout.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    // 一维上窗口完全落在输入内的输出范围 [lo, hi)
+    void interior_range(int out, int in, int extent, int stride, int pad, int& lo, int& hi)
+    {
+        lo = (pad + stride - 1) / stride;
+        int last = in + pad - extent;
+        hi = last < 0 ? 0 : last / stride + 1;
+        hi = min(hi, out);
+        lo = min(lo, hi);
+    }
+
+    // CHW 的 2x2 / 步长 2 最大池化的一行：先两行逐元素取最大 (竖直方向)，再把相邻两列成对取最大 (水平方向)。
+    // SSE2 下一次读取 8 列，用 shuffle 分出偶数列与奇数列后取最大，得到 4 个输出
+    void max_2x2_row(const float* r0, const float* r1, float* out, int n)
+    {
+        int j = 0;
+#ifdef FAST_MATH_SSE2
+        for (; j + 4 <= n; j += 4)
+        {
+            __m128 a = _mm_max_ps(_mm_loadu_ps(r0 + 2 * j), _mm_loadu_ps(r1 + 2 * j));
+            __m128 b = _mm_max_ps(_mm_loadu_ps(r0 + 2 * j + 4), _mm_loadu_ps(r1 + 2 * j + 4));
+            __m128 even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 odd = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_ps(out + j, _mm_max_ps(even, odd));
+        }
+#endif
+        for (; j < n; j++)
+        {
+            out[j] = max(max(r0[2 * j], r0[2 * j + 1]), max(r1[2 * j], r1[2 * j + 1]));
+        }
+    }
+
+    // 通用路径：in / out 为一组连续通道 (group 个，CHW 时为 1) 按像素交错存放的平面，
+    // 计算 [oh0, oh1) x [ow0, ow1) 范围内的输出
+    void pool_rect(const float* in, float* out, int group, int in_h, int in_w, int out_w,
+                   const pool_params& p, pool_kind kind, int pad_top, int pad_left,
+                   int oh0, int oh1, int ow0, int ow1, vector<float>& acc)
+    {
+        for (int oh = oh0; oh < oh1; oh++)
+        {
+            int ih_start = oh * p.stride_h - pad_top;
+            for (int ow = ow0; ow < ow1; ow++)
+            {
+                int iw_start = ow * p.stride_w - pad_left;
+                fill(acc.begin(), acc.end(), kind == pool_kind::max ? numeric_limits<float>::lowest() : 0.0f);
+                int count = 0;
+                for (int ph = 0; ph < p.kernel_h; ph++)
+                {
+                    int ih = ih_start + ph * p.dilation_h;
+                    if (ih < 0 || ih >= in_h) continue;
+                    for (int pw = 0; pw < p.kernel_w; pw++)
+                    {
+                        int iw = iw_start + pw * p.dilation_w;
+                        if (iw < 0 || iw >= in_w) continue;
+                        const float* px = in + (static_cast<size_t>(ih) * in_w + iw) * group;
+                        if (kind == pool_kind::max)
+                        {
+                            for (int v = 0; v < group; v++) acc[v] = max(acc[v], px[v]);
+                        }
+                        else
+                        {
+                            for (int v = 0; v < group; v++) acc[v] += px[v];
+                        }
+                        count++;
+                    }
+                }
+
+                float* dst = out + (static_cast<size_t>(oh) * out_w + ow) * group;
+                if (kind == pool_kind::average)
+                {
+                    float scale = count > 0 ? 1.0f / count : 0.0f;
+                    for (int v = 0; v < group; v++) dst[v] = acc[v] * scale;
+                }
+                else
+                {
+                    copy(acc.begin(), acc.end(), dst);
+                }
+            }
+        }
+    }
+
+    // 2x2 / 步长 2 最大池化的内部区域 (窗口完全落在输入内)
+    void max_2x2_interior(const float* in, float* out, int group, int in_w, int out_w, int pad_top, int pad_left,
+                          int oh0, int oh1, int ow0, int ow1)
+    {
+        for (int oh = oh0; oh < oh1; oh++)
+        {
+            const float* r0 = in + static_cast<size_t>(oh * 2 - pad_top) * in_w * group;
+            const float* r1 = r0 + static_cast<size_t>(in_w) * group;
+            if (group == 1)
+            {
+                max_2x2_row(r0 + ow0 * 2 - pad_left, r1 + ow0 * 2 - pad_left, out + static_cast<size_t>(oh) * out_w + ow0, ow1 - ow0);
+                continue;
+            }
+            // 交错布局：四个像素的同一组通道逐元素取最大；CHWc 时组大小是编译期常量，可以整组向量化
+            for (int ow = ow0; ow < ow1; ow++)
+            {
+                const float* a = r0 + static_cast<size_t>(ow * 2 - pad_left) * group;
+                const float* b = r1 + static_cast<size_t>(ow * 2 - pad_left) * group;
+                float* dst = out + (static_cast<size_t>(oh) * out_w + ow) * group;
+                if (group == channel_block)
+                {
+                    for (int v = 0; v < channel_block; v++) dst[v] = max(max(a[v], a[v + channel_block]), max(b[v], b[v + channel_block]));
+                }
+                else
+                {
+                    for (int v = 0; v < group; v++) dst[v] = max(max(a[v], a[v + group]), max(b[v], b[v + group]));
+                }
+            }
+        }
+    }
+}
+
+int pooled_size(int in, int kernel, int stride, int pad, int dilation, bool ceil_mode)
+{
+    if (kernel <= 0 || stride <= 0 || dilation <= 0 || pad < 0)
+    {
+        throw invalid_argument("pooling: kernel, stride and dilation must be positive and padding non-negative");
+    }
+    int extent = dilation * (kernel - 1) + 1;
+    int span = in + 2 * pad - extent;
+    if (span < 0)
+    {
+        throw invalid_argument("pooling: window is larger than the padded input");
+    }
+    int out = (ceil_mode ? (span + stride - 1) / stride : span / stride) + 1;
+    // 向上取整多出的窗口若完全落在右/下填充里则去掉
+    if (ceil_mode && (out - 1) * stride >= in + pad) out--;
+    return out;
+}
+
+vector<int> pooled_shape(const vector<int>& input_shape, const pool_params& params)
+{
+    if (input_shape.size() != 3)
+    {
+        throw invalid_argument("pooling: expects [C, H, W] input");
+    }
+    return {input_shape[0],
+            pooled_size(input_shape[1], params.kernel_h, params.stride_h, params.pad_h, params.dilation_h, params.ceil_mode),
+            pooled_size(input_shape[2], params.kernel_w, params.stride_w, params.pad_w, params.dilation_w, params.ceil_mode)};
+}
+
+void pooled_window(const pool_params& params, spatial_window& window)
+{
+    window.kernel_h = params.dilation_h * (params.kernel_h - 1) + 1;
+    window.kernel_w = params.dilation_w * (params.kernel_w - 1) + 1;
+    window.stride_h = params.stride_h;
+    window.stride_w = params.stride_w;
+    window.pad_h = params.pad_h;
+    window.pad_w = params.pad_w;
+}
+
+void pool_forward(const Tensor& input, Tensor& output, const pool_params& params, pool_kind kind,
+                  int pad_top, int pad_left, int out_h, int out_w)
+{
+    if (input.shape.size() != 3)
+    {
+        throw invalid_argument("pooling: expects [C, H, W] input");
+    }
+    int channels = input.shape[0];
+    int in_h = input.shape[1];
+    int in_w = input.shape[2];
+
+    output.shape = {channels, out_h, out_w};
+    output.data.resize(output.size());
+    output.layout = input.layout;
+
+    // 每组 group 个通道按像素交错，共 blocks 组：CHW 每组 1 个通道，CHWc 每组 channel_block 个，HWC 一组包含全部通道
+    int group = 1;
+    if (input.layout == TensorLayout::CHWc) group = channel_block;
+    else if (input.layout == TensorLayout::HWC) group = channels;
+    int blocks = channels / group;
+
+    bool fast = kind == pool_kind::max && params.kernel_h == 2 && params.kernel_w == 2 && params.stride_h == 2 &&
+                params.stride_w == 2 && params.dilation_h == 1 && params.dilation_w == 1;
+    int oh_lo = 0, oh_hi = 0, ow_lo = 0, ow_hi = 0;
+    if (fast)
+    {
+        interior_range(out_h, in_h, 2, 2, pad_top, oh_lo, oh_hi);
+        interior_range(out_w, in_w, 2, 2, pad_left, ow_lo, ow_hi);
+    }
+
+    vector<float> acc(group);
+    for (int b = 0; b < blocks; b++)
+    {
+        const float* in_b = input.data.data() + static_cast<size_t>(b) * in_h * in_w * group;
+        float* out_b = output.data.data() + static_cast<size_t>(b) * out_h * out_w * group;
+        if (!fast)
+        {
+            pool_rect(in_b, out_b, group, in_h, in_w, out_w, params, kind, pad_top, pad_left, 0, out_h, 0, out_w, acc);
+            continue;
+        }
+
+        // 内部走快速路径，四周的边框 (填充或 ceil_mode 多出的部分) 走通用路径
+        max_2x2_interior(in_b, out_b, group, in_w, out_w, pad_top, pad_left, oh_lo, oh_hi, ow_lo, ow_hi);
+        pool_rect(in_b, out_b, group, in_h, in_w, out_w, params, kind, pad_top, pad_left, 0, oh_lo, 0, out_w, acc);
+        pool_rect(in_b, out_b, group, in_h, in_w, out_w, params, kind, pad_top, pad_left, oh_hi, out_h, 0, out_w, acc);
+        pool_rect(in_b, out_b, group, in_h, in_w, out_w, params, kind, pad_top, pad_left, oh_lo, oh_hi, 0, ow_lo, acc);
+        pool_rect(in_b, out_b, group, in_h, in_w, out_w, params, kind, pad_top, pad_left, oh_lo, oh_hi, ow_hi, out_w, acc);
+    }
+}
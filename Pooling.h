@@ -0,0 +1,43 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef POOLING_H
+#define POOLING_H
+
+#include "layer.h"
+#include "Tensor.h"
+#include <vector>
+
+using namespace std;
+
+// 池化窗口参数：输出 (oh, ow) 的第 (ph, pw) 个抽头位于输入
+// (oh * stride_h - pad_h + ph * dilation_h, ow * stride_w - pad_w + pw * dilation_w)，落在输入外的抽头不参与计算
+struct pool_params
+{
+    int kernel_h = 2, kernel_w = 2;
+    int stride_h = 2, stride_w = 2;
+    int pad_h = 0, pad_w = 0;
+    int dilation_h = 1, dilation_w = 1;
+    bool ceil_mode = false;   // 输出尺寸向上取整，但最后一个窗口必须从输入或左/上填充内开始
+};
+
+enum class pool_kind
+{
+    max,
+    average   // 除以窗口内有效 (未越界) 抽头的个数
+};
+
+// 一维上的输出尺寸；窗口比带填充的输入还大时抛出 invalid_argument
+int pooled_size(int in, int kernel, int stride, int pad, int dilation, bool ceil_mode);
+
+// 按 params 的窗口、以显式的上/左填充计算 out_h x out_w 个输出，输出保持输入的布局 (CHW / CHWc / HWC)。
+// 2x2、步长 2、无空洞的最大池化在窗口完全落在输入内的区域走向量化的快速路径
+void pool_forward(const Tensor& input, Tensor& output, const pool_params& params, pool_kind kind,
+                  int pad_top, int pad_left, int out_h, int out_w);
+
+// 池化层共用的形状与窗口计算
+vector<int> pooled_shape(const vector<int>& input_shape, const pool_params& params);
+void pooled_window(const pool_params& params, spatial_window& window);
+
+#endif //POOLING_H
@@ -0,0 +1,145 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "Preprocess.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+using namespace std;
+
+cv::Mat read_image(const string& path)
+{
+    cv::Mat image = cv::imread(path);
+    if (image.empty())
+    {
+        throw runtime_error("Image load failed: " + path);
+    }
+    return image;
+}
+
+int choose_decode_scale(int src_h, int src_w, int target_h, int target_w)
+{
+    if (target_h <= 0 || target_w <= 0) return 1;
+
+    int src_short = min(src_h, src_w);
+    int target_long = max(target_h, target_w);
+    for (int scale : {8, 4, 2})
+    {
+        // libjpeg 缩放后的尺寸为 ceil(src / scale)
+        if ((src_short + scale - 1) / scale >= target_long) return scale;
+    }
+    return 1;
+}
+
+bool read_jpeg_size(const vector<uchar>& bytes, int& height, int& width)
+{
+    size_t n = bytes.size();
+    if (n < 4 || bytes[0] != 0xFF || bytes[1] != 0xD8) return false;
+
+    size_t pos = 2;
+    while (pos + 4 <= n)
+    {
+        if (bytes[pos] != 0xFF) return false;
+        uchar marker = bytes[pos + 1];
+        if (marker == 0xFF) { pos++; continue; }     // 填充字节
+        if (marker == 0xD8 || marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) { pos += 2; continue; }
+        if (marker == 0xD9 || marker == 0xDA) return false;   // 在 SOF 之前到达扫描段或文件结束
+
+        size_t length = (bytes[pos + 2] << 8) | bytes[pos + 3];
+        // SOF0-SOF15，排除 DHT(C4)、JPG(C8)、DAC(CC)
+        bool is_sof = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+        if (is_sof)
+        {
+            if (pos + 9 > n) return false;
+            height = (bytes[pos + 5] << 8) | bytes[pos + 6];
+            width = (bytes[pos + 7] << 8) | bytes[pos + 8];
+            return height > 0 && width > 0;
+        }
+        pos += 2 + length;
+    }
+    return false;
+}
+
+cv::Mat read_image(const string& path, int target_h, int target_w)
+{
+    ifstream file(path, ios::binary);
+    if (!file)
+    {
+        throw runtime_error("Image load failed: " + path);
+    }
+    vector<uchar> bytes((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    cv::Mat image = decode_image(bytes, target_h, target_w);
+    if (image.empty())
+    {
+        throw runtime_error("Image load failed: " + path);
+    }
+    return image;
+}
+
+cv::Mat decode_image(const vector<uchar>& bytes, int target_h, int target_w)
+{
+    int flags = cv::IMREAD_COLOR;
+    int src_h = 0, src_w = 0;
+    if (read_jpeg_size(bytes, src_h, src_w))
+    {
+        switch (choose_decode_scale(src_h, src_w, target_h, target_w))
+        {
+        case 8: flags = cv::IMREAD_REDUCED_COLOR_8; break;
+        case 4: flags = cv::IMREAD_REDUCED_COLOR_4; break;
+        case 2: flags = cv::IMREAD_REDUCED_COLOR_2; break;
+        default: break;
+        }
+    }
+
+    return cv::imdecode(bytes, flags);
+}
+
+void image_to_tensor(const cv::Mat& image, int target_h, int target_w, Tensor& output, TensorLayout layout)
+{
+    if (image.empty() || image.depth() != CV_8U)
+    {
+        throw invalid_argument("image_to_tensor: expects a non-empty 8-bit image");
+    }
+
+    cv::Mat resized = image;
+    if (target_h > 0 && target_w > 0 && (image.rows != target_h || image.cols != target_w))
+    {
+        cv::resize(image, resized, cv::Size(target_w, target_h), 0, 0, cv::INTER_AREA);
+    }
+
+    int channels = resized.channels();
+    int height = resized.rows;
+    int width = resized.cols;
+
+    vector<int> shape = {channels, height, width};
+    if (output.shape != shape)
+    {
+        output.shape = shape;
+        output.data.resize(output.size());
+    }
+    output.layout = layout;
+
+    if (layout == TensorLayout::HWC)
+    {
+        cv::Mat dst(height, width, CV_32FC(channels), output.data.data());
+        resized.convertTo(dst, CV_32F, 1.0 / 255.0);
+        return;
+    }
+    if (layout != TensorLayout::CHW)
+    {
+        throw invalid_argument("image_to_tensor: layout must be CHW or HWC");
+    }
+
+    // 先按通道拆分 (HWC -> CHW)，再把每个平面直接转换写入 Tensor 的内存
+    vector<cv::Mat> planes;
+    cv::split(resized, planes);
+    for (int c = 0; c < channels; c++)
+    {
+        cv::Mat dst(height, width, CV_32F, output.data.data() + c * height * width);
+        planes[c].convertTo(dst, CV_32F, 1.0 / 255.0);
+    }
+}
@@ -0,0 +1,36 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef PREPROCESS_H
+#define PREPROCESS_H
+
+#include "Tensor.h"
+#include <string>
+#include <opencv2/opencv.hpp>
+
+using namespace std;
+
+// 读取图像文件 (BGR，8 位)，失败时抛出 runtime_error
+cv::Mat read_image(const string& path);
+
+// 读取图像并直接以降低的分辨率解码：JPEG 按文件头中的尺寸自动选择
+// IMREAD_REDUCED_COLOR_2/4/8 (libjpeg 在 DCT 域缩放)，保证结果不小于 target_h x target_w
+cv::Mat read_image(const string& path, int target_h, int target_w);
+
+// read_image 的解码部分：对已读入内存的文件字节按同样的规则降分辨率解码，失败时返回空图像
+cv::Mat decode_image(const vector<uchar>& bytes, int target_h, int target_w);
+
+// 根据源尺寸和目标尺寸选择解码缩小倍数 (1/2/4/8)。
+// 按短边与目标长边比较，因此 EXIF 旋转后仍不会小于目标尺寸
+int choose_decode_scale(int src_h, int src_w, int target_h, int target_w);
+
+// 从 JPEG 数据的 SOF 段读取尺寸，不是 JPEG 或解析失败时返回 false
+bool read_jpeg_size(const vector<uchar>& bytes, int& height, int& width);
+
+// 把 8 位 BGR 图像缩放到 target_h x target_w (为 0 时保持原尺寸)，归一化到 [0, 1]，
+// 并按 layout (CHW 或 HWC) 写入 output。HWC 与 OpenCV 的排布相同，只做类型转换，没有转置。
+// output 形状一致时复用其内存，不重新分配
+void image_to_tensor(const cv::Mat& image, int target_h, int target_w, Tensor& output, TensorLayout layout = TensorLayout::CHW);
+
+#endif //PREPROCESS_H
@@ -12,12 +12,26 @@ vector<int> reluLayer::get_output_shape(const vector<int>& input_shape) const
     return input_shape;
 }
 
+bool reluLayer::get_spatial_window(spatial_window& window) const
+{
+    window = spatial_window();
+    return true;
+}
+
 void reluLayer::forward(const Tensor& input, Tensor& output)
 {
     output.shape = input.shape;
+    output.layout = input.layout;   // 逐元素运算，任何布局都直接沿用
     output.data.resize(input.size());
     for (int i = 0; i < input.size(); i++)
     {
         output.data[i] = max(0.0f, input.data[i]);
     }
-}
\ No newline at end of file
+}
+void reluLayer::forward_inplace(Tensor& tensor)
+{
+    for (float& v : tensor.data)
+    {
+        v = max(0.0f, v);
+    }
+}
@@ -15,7 +15,11 @@ class reluLayer : public layer
 public:
     reluLayer() = default;
     void forward(const Tensor& input, Tensor& output) override;
+    bool supports_inplace() const override { return true; }
+    void forward_inplace(Tensor& tensor) override;
     std::vector<int> get_output_shape(const std::vector<int>& input_shape)const override;
+    // 逐元素层：1x1 窗口、步长 1
+    bool get_spatial_window(spatial_window& window) const override;
     virtual ~reluLayer() = default;
 };
 
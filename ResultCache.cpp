@@ -0,0 +1,132 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "ResultCache.h"
+#include "Preprocess.h"
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+using namespace std;
+
+void ResultCacheStats::print(ostream& os) const
+{
+    os << "cache: " << hits << " hits, " << misses << " misses (hit rate " << hit_rate() * 100.0 << "%), "
+       << entries << " entries, " << evictions << " evictions, " << invalidations << " invalidations" << endl;
+}
+
+ResultCache::ResultCache(size_t m_capacity) : capacity(m_capacity)
+{
+    if (capacity == 0)
+    {
+        throw invalid_argument("ResultCache: capacity must be greater than zero");
+    }
+}
+
+bool ResultCache::lookup(const Hash128& key, Tensor& value, uint64_t& m_generation)
+{
+    lock_guard<mutex> lock(mtx);
+    m_generation = generation;
+    auto it = index.find(key);
+    if (it == index.end())
+    {
+        counters.misses++;
+        return false;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    value = it->second->value;
+    counters.hits++;
+    return true;
+}
+
+void ResultCache::insert(const Hash128& key, const Tensor& value, uint64_t m_generation)
+{
+    lock_guard<mutex> lock(mtx);
+    if (m_generation != generation) return;   // 结果来自失效前的模型
+
+    auto it = index.find(key);
+    if (it != index.end())
+    {
+        it->second->value = value;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+
+    entries.push_front({key, value});
+    index[key] = entries.begin();
+    if (entries.size() > capacity)
+    {
+        index.erase(entries.back().key);
+        entries.pop_back();
+        counters.evictions++;
+    }
+    counters.entries = entries.size();
+}
+
+void ResultCache::invalidate()
+{
+    lock_guard<mutex> lock(mtx);
+    entries.clear();
+    index.clear();
+    generation++;
+    counters.invalidations++;
+    counters.entries = 0;
+}
+
+ResultCacheStats ResultCache::stats() const
+{
+    lock_guard<mutex> lock(mtx);
+    return counters;
+}
+
+Hash128 hash_tensor(const Tensor& tensor)
+{
+    // shape 始终是逻辑上的 {C, H, W}，同样的字节在 CHW 与 HWC 下是不同的图像，布局也要计入种子
+    Hash128 shape_hash = hash128(tensor.shape.data(), tensor.shape.size() * sizeof(int), static_cast<uint64_t>(tensor.layout));
+    return hash128(tensor.data.data(), tensor.data.size() * sizeof(float), shape_hash.low ^ shape_hash.high);
+}
+
+CachedPredictor::CachedPredictor(CNN& m_cnn, size_t capacity) : cnn(m_cnn), cache(capacity)
+{
+}
+
+Tensor CachedPredictor::predict(Tensor& input)
+{
+    Hash128 key = hash_tensor(input);
+    Tensor result;
+    uint64_t generation = 0;
+    if (cache.lookup(key, result, generation)) return result;
+
+    result = cnn.predict(input);
+    cache.insert(key, result, generation);
+    return result;
+}
+
+Tensor CachedPredictor::predict_file(const string& path, int input_h, int input_w)
+{
+    ifstream file(path, ios::binary);
+    if (!file)
+    {
+        throw runtime_error("Could not read the image: " + path);
+    }
+    vector<uchar> bytes((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    // 目标尺寸不同，预处理结果不同，一并计入键
+    Hash128 key = hash128(bytes.data(), bytes.size(), (static_cast<uint64_t>(input_h) << 32) | static_cast<uint32_t>(input_w));
+    Tensor result;
+    uint64_t generation = 0;
+    if (cache.lookup(key, result, generation)) return result;
+
+    // 与不经缓存的 read_image(path, h, w) 相同的降分辨率解码，命中与否结果一致
+    cv::Mat image = decode_image(bytes, input_h, input_w);
+    if (image.empty())
+    {
+        throw runtime_error("Could not decode the image: " + path);
+    }
+    Tensor input;
+    image_to_tensor(image, input_h, input_w, input);
+    result = cnn.predict(input);
+    cache.insert(key, result, generation);
+    return result;
+}
@@ -0,0 +1,85 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "CNN.h"
+#include "Hash.h"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+struct ResultCacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t invalidations = 0;
+    size_t entries = 0;
+
+    double hit_rate() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+    void print(ostream& os) const;
+};
+
+// 以内容哈希为键的 LRU 结果缓存，线程安全。
+// invalidate() 清空缓存并递增代数；insert 时携带查询时的代数，失效之前开始的推理结果不会被写入，
+// 因此换模型后不会读到旧模型的结果
+class ResultCache
+{
+private:
+    struct Entry
+    {
+        Hash128 key;
+        Tensor value;
+    };
+
+    size_t capacity;
+    list<Entry> entries;   // 头部为最近使用
+    unordered_map<Hash128, list<Entry>::iterator, Hash128Hasher> index;
+    uint64_t generation = 0;
+    ResultCacheStats counters;
+    mutable mutex mtx;
+
+public:
+    explicit ResultCache(size_t m_capacity);
+
+    // 命中时写入 value 并返回 true；generation 返回当前代数，供之后的 insert 使用
+    bool lookup(const Hash128& key, Tensor& value, uint64_t& m_generation);
+    void insert(const Hash128& key, const Tensor& value, uint64_t m_generation);
+
+    // 模型重新加载时调用
+    void invalidate();
+
+    ResultCacheStats stats() const;
+};
+
+// CNN::predict 前的可选缓存层：键为输入张量 (形状与数据) 的哈希，或原始图像文件字节的哈希
+class CachedPredictor
+{
+private:
+    CNN& cnn;
+    ResultCache cache;
+
+public:
+    CachedPredictor(CNN& m_cnn, size_t capacity);
+
+    Tensor predict(Tensor& input);
+
+    // 按文件字节查找，命中时连解码也省去；未命中时解码、预处理到 input_h x input_w 再推理
+    Tensor predict_file(const string& path, int input_h = 128, int input_w = 128);
+
+    void invalidate() { cache.invalidate(); }
+    ResultCacheStats stats() const { return cache.stats(); }
+};
+
+// 张量形状、布局与数据一起参与哈希，数据相同但形状或布局不同的输入不会冲突
+Hash128 hash_tensor(const Tensor& tensor);
+
+#endif //RESULT_CACHE_H
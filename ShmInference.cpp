@@ -0,0 +1,211 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "ShmInference.h"
+#include "ImageView.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    // 输出槽的大小 (float 个数)，足够容纳分类结果
+    const uint32_t shm_output_floats = 64;
+
+    string output_name(const string& name, uint32_t client_id)
+    {
+        return name + "_out_" + to_string(client_id);
+    }
+
+    // C*H*W，乘积溢出 size_t 时返回 false
+    bool checked_volume(uint32_t c, uint32_t h, uint32_t w, size_t& volume)
+    {
+        volume = c;
+        for (uint32_t d : {h, w})
+        {
+            if (d != 0 && volume > SIZE_MAX / d) return false;
+            volume *= d;
+        }
+        return true;
+    }
+}
+
+void ShmServeStats::print(ostream& os) const
+{
+    os << "shm: " << requests << " requests in " << batches << " batches ("
+       << (batches > 0 ? static_cast<double>(requests) / batches : 0.0) << " per batch), dropped " << dropped << endl;
+}
+
+ShmInferenceServer::ShmInferenceServer(CNN& m_cnn, const string& m_name, uint32_t slots, int channels, int height,
+                                       int width, size_t m_batch_size)
+    : cnn(m_cnn), name(m_name),
+      input(m_name + "_in", slots, static_cast<uint32_t>(sizeof(ShmTensorHeader) + sizeof(float) * channels * height * width)),
+      batch_size(max<size_t>(1, m_batch_size)), channels(channels), height(height), width(width)
+{
+}
+
+ShmRing* ShmInferenceServer::output_ring(uint32_t client_id, uint32_t instance)
+{
+    auto it = outputs.find(client_id);
+    if (it != outputs.end())
+    {
+        if (it->second->instance() == instance) return it->second.get();
+        outputs.erase(it);   // 客户端已重启：旧映射指向被删除的共享内存，写入它的结果没有人读
+    }
+    try
+    {
+        auto ring = make_unique<ShmRing>(output_name(name, client_id));
+        if (ring->instance() != instance) return nullptr;   // 请求来自已退出的旧客户端
+        ShmRing* result = ring.get();
+        outputs[client_id] = std::move(ring);
+        return result;
+    }
+    catch (const runtime_error&)
+    {
+        return nullptr;   // 客户端已退出
+    }
+}
+
+size_t ShmInferenceServer::serve_once(int timeout_ms)
+{
+    vector<ShmSlot> slots;
+    if (input.peek(batch_size, slots) == 0)
+    {
+        if (!input.wait_for_data(timeout_ms)) return 0;
+        input.peek(batch_size, slots);
+    }
+
+    for (const ShmSlot& s : slots)
+    {
+        if (s.tag == ShmRing::cancelled_tag) continue;   // 客户端认领后放弃的槽
+
+        // 直接在共享内存上建立视图，predict 不拷贝输入
+        // 槽内容来自其他进程，不可信：形状必须与服务端配置一致且数据完整，推理失败也只丢弃这一个请求
+        if (s.length < sizeof(ShmTensorHeader))
+        {
+            stats.dropped++;
+            continue;
+        }
+        const ShmTensorHeader* shape = static_cast<const ShmTensorHeader*>(s.data);
+        size_t floats = 0;
+        if (!checked_volume(shape->channels, shape->height, shape->width, floats) ||
+            shape->channels != static_cast<uint32_t>(channels) || shape->height != static_cast<uint32_t>(height) ||
+            shape->width != static_cast<uint32_t>(width) || (s.length - sizeof(ShmTensorHeader)) / sizeof(float) < floats)
+        {
+            stats.dropped++;
+            continue;
+        }
+        Tensor output;
+        try
+        {
+            ImageView view(static_cast<const char*>(s.data) + sizeof(ShmTensorHeader), PixelType::F32, PixelLayout::CHW,
+                           channels, height, width);
+            output = cnn.predict(view);
+        }
+        catch (const exception& e)
+        {
+            cerr << "shm: request " << s.user << " from client " << s.tag << " failed: " << e.what() << endl;
+            stats.dropped++;
+            continue;
+        }
+
+        ShmRing* ring = output_ring(s.tag, shape->output_instance);
+        uint64_t ticket = 0;
+        void* target = ring ? ring->claim(ticket, 1000) : nullptr;
+        if (!target)
+        {
+            // 输出队列长时间已满，多半是客户端已停止读取：丢掉缓存的映射，下一个请求重新打开
+            if (ring) outputs.erase(s.tag);
+            stats.dropped++;
+            continue;
+        }
+        uint32_t count = min<uint32_t>(static_cast<uint32_t>(output.data.size()), shm_output_floats);
+        memcpy(target, output.data.data(), count * sizeof(float));
+        ring->publish(ticket, count * sizeof(float), 0, s.user);
+    }
+
+    // 整批处理完才交还输入槽，生产者在此之前不会覆盖正在读取的数据
+    input.release(slots.size());
+    stats.requests += slots.size();
+    stats.batches++;
+    return slots.size();
+}
+
+void ShmInferenceServer::serve(const atomic<bool>& stop)
+{
+    while (!stop.load())
+    {
+        serve_once(100);
+    }
+}
+
+ShmInferenceClient::ShmInferenceClient(const string& name, uint32_t m_client_id, uint32_t slots)
+    : client_id(m_client_id), output(output_name(name, m_client_id), slots, shm_output_floats * sizeof(float)),
+      input(name + "_in")
+{
+    if (client_id == ShmRing::cancelled_tag)
+    {
+        throw invalid_argument("ShmInferenceClient: client id is reserved");
+    }
+}
+
+float* ShmInferenceClient::begin_request(uint64_t& ticket, int channels, int height, int width, int timeout_ms)
+{
+    size_t bytes = sizeof(ShmTensorHeader) + sizeof(float) * channels * height * width;
+    if (bytes > input.slot_bytes())
+    {
+        throw invalid_argument("ShmInferenceClient: tensor does not fit in a slot");
+    }
+    void* payload = input.claim(ticket, timeout_ms);
+    if (!payload) return nullptr;
+
+    ShmTensorHeader* shape = static_cast<ShmTensorHeader*>(payload);
+    shape->channels = static_cast<uint32_t>(channels);
+    shape->height = static_cast<uint32_t>(height);
+    shape->width = static_cast<uint32_t>(width);
+    shape->output_instance = output.instance();
+    return reinterpret_cast<float*>(shape + 1);
+}
+
+void ShmInferenceClient::submit(uint64_t ticket, uint64_t request_id)
+{
+    input.publish(ticket, input.slot_bytes(), client_id, request_id);
+}
+
+void ShmInferenceClient::cancel(uint64_t ticket)
+{
+    input.cancel(ticket);
+}
+
+bool ShmInferenceClient::submit(const Tensor& tensor, uint64_t request_id, int timeout_ms)
+{
+    if (tensor.shape.size() != 3 || tensor.layout != TensorLayout::CHW)
+    {
+        throw invalid_argument("ShmInferenceClient: tensor must be CHW");
+    }
+    uint64_t ticket = 0;
+    float* target = begin_request(ticket, tensor.shape[0], tensor.shape[1], tensor.shape[2], timeout_ms);
+    if (!target) return false;
+    copy(tensor.data.begin(), tensor.data.end(), target);
+    submit(ticket, request_id);
+    return true;
+}
+
+bool ShmInferenceClient::receive(uint64_t& request_id, vector<float>& result, int timeout_ms)
+{
+    vector<ShmSlot> slots;
+    if (output.peek(1, slots) == 0)
+    {
+        if (!output.wait_for_data(timeout_ms) || output.peek(1, slots) == 0) return false;
+    }
+    const float* values = static_cast<const float*>(slots[0].data);
+    result.assign(values, values + slots[0].length / sizeof(float));
+    request_id = slots[0].user;
+    output.release(1);
+    return true;
+}
@@ -0,0 +1,90 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef SHM_INFERENCE_H
+#define SHM_INFERENCE_H
+
+#include "CNN.h"
+#include "ShmRing.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// 输入槽开头的形状描述，其后紧跟 C*H*W 个 float (CHW)
+struct ShmTensorHeader
+{
+    uint32_t channels = 0;
+    uint32_t height = 0;
+    uint32_t width = 0;
+    uint32_t output_instance = 0;   // 客户端输出队列的 ShmRing::instance()，服务端据此发现客户端重启后重建的队列
+};
+
+struct ShmServeStats
+{
+    uint64_t requests = 0;
+    uint64_t batches = 0;
+    uint64_t dropped = 0;   // 形状不符、推理失败，或客户端输出队列不存在 / 长时间已满而丢弃的请求
+
+    void print(ostream& os) const;
+};
+
+// 共享内存推理服务端：创建输入队列 <name>_in，批量取出客户端写好的 CHW 张量，
+// 以 ImageView 直接在共享内存上调用 CNN::predict (不拷贝)，结果写回客户端 id 对应的输出队列 <name>_out_<id>
+class ShmInferenceServer
+{
+private:
+    CNN& cnn;
+    string name;
+    ShmRing input;
+    map<uint32_t, unique_ptr<ShmRing>> outputs;
+    size_t batch_size;
+    int channels, height, width;   // 接受的输入形状，形状不符的请求计为丢弃
+    ShmServeStats stats;
+
+    // 取客户端的输出队列；缓存的映射与请求中的 instance 不符 (客户端以同一编号重启) 时重新打开
+    ShmRing* output_ring(uint32_t client_id, uint32_t instance);
+
+public:
+    ShmInferenceServer(CNN& m_cnn, const string& m_name, uint32_t slots = 64, int channels = 3, int height = 128,
+                       int width = 128, size_t m_batch_size = 16);
+
+    // 处理请求直到 stop 为 true；队列空时在 futex/事件上休眠
+    void serve(const atomic<bool>& stop);
+    // 处理当前已就绪的至多一批请求，返回处理的个数
+    size_t serve_once(int timeout_ms);
+
+    const ShmServeStats& get_stats() const { return stats; }
+};
+
+// 共享内存推理客户端：每个进程使用不同的 client_id (不能是 ShmRing::cancelled_tag)，先创建自己的输出队列再连接服务端的输入队列。
+// begin_request 认领槽之后必须调用 submit 或 cancel，否则服务端会停在该槽上；耗时或可能失败的准备工作应放在认领之前
+class ShmInferenceClient
+{
+private:
+    uint32_t client_id;
+    ShmRing output;
+    ShmRing input;
+
+public:
+    ShmInferenceClient(const string& name, uint32_t m_client_id, uint32_t slots = 64);
+
+    // 零拷贝写入：返回输入槽内 C*H*W 个 float 的写入位置 (等待至多 timeout_ms)，写完后调用 submit
+    float* begin_request(uint64_t& ticket, int channels, int height, int width, int timeout_ms = 1000);
+    void submit(uint64_t ticket, uint64_t request_id);
+    // 放弃 begin_request 认领的槽 (例如填充数据时出错)，服务端会跳过它
+    void cancel(uint64_t ticket);
+
+    // 拷贝 tensor 到输入槽并提交，队列满超时返回 false
+    bool submit(const Tensor& tensor, uint64_t request_id, int timeout_ms = 1000);
+
+    // 等待一个结果，超时返回 false
+    bool receive(uint64_t& request_id, vector<float>& result, int timeout_ms = 1000);
+};
+
+#endif //SHM_INFERENCE_H
@@ -0,0 +1,370 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "ShmRing.h"
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+using namespace std;
+
+namespace
+{
+    const uint64_t shm_ring_magic = 0x474E495248534D43ull;  // "CMSHRING"
+
+    size_t round_up(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    uint32_t next_power_of_two(uint32_t value)
+    {
+        uint32_t result = 1;
+        while (result < value) result <<= 1;
+        return result;
+    }
+}
+
+// 共享内存开头的控制块；生产者与消费者使用的计数器分处不同缓存行，避免伪共享
+struct ShmRing::Header
+{
+    uint64_t magic;
+    uint32_t slot_count;
+    uint32_t slot_bytes;
+    uint64_t slot_stride;
+    uint64_t total_bytes;
+    uint32_t instance;
+    alignas(64) atomic<uint64_t> write_position;   // 生产者竞争的认领计数
+    alignas(64) atomic<uint32_t> data_signal;      // 每次 publish 加一，消费者在其上等待
+    atomic<uint32_t> consumer_waiting;
+    alignas(64) atomic<uint32_t> space_signal;     // 每次 release 加一，生产者在其上等待
+    atomic<uint32_t> producers_waiting;
+};
+
+struct ShmRing::SlotHeader
+{
+    atomic<uint64_t> sequence;
+    uint32_t length;
+    uint32_t tag;
+    uint64_t user;
+};
+
+static_assert(sizeof(atomic<uint64_t>) == 8 && sizeof(atomic<uint32_t>) == 4, "ShmRing: unexpected atomic layout");
+
+ShmRing::ShmRing(const string& m_name, uint32_t slot_count, uint32_t slot_bytes) : name(m_name), owner(true)
+{
+    if (slot_count == 0 || slot_bytes == 0)
+    {
+        throw invalid_argument("ShmRing: slot_count and slot_bytes must be greater than zero");
+    }
+    slot_count = next_power_of_two(slot_count);
+    size_t stride = round_up(sizeof(SlotHeader) + slot_bytes, 64);
+    size_t total = round_up(sizeof(Header), 64) + stride * slot_count;
+
+    map_region(total, true);
+
+    header = new (base) Header();
+    header->slot_count = slot_count;
+    header->slot_bytes = slot_bytes;
+    header->slot_stride = stride;
+    header->total_bytes = total;
+    header->instance = random_device{}() ^ static_cast<uint32_t>(chrono::steady_clock::now().time_since_epoch().count());
+    header->write_position.store(0);
+    header->data_signal.store(0);
+    header->consumer_waiting.store(0);
+    header->space_signal.store(0);
+    header->producers_waiting.store(0);
+    for (uint32_t i = 0; i < slot_count; i++)
+    {
+        SlotHeader* s = new (slot(i)) SlotHeader();
+        s->sequence.store(i, memory_order_relaxed);
+    }
+    // 最后写入 magic，打开方看到它时控制块已初始化完毕
+    atomic_thread_fence(memory_order_release);
+    header->magic = shm_ring_magic;
+}
+
+ShmRing::ShmRing(const string& m_name) : name(m_name)
+{
+    map_region(0, false);
+    header = static_cast<Header*>(base);
+    if (header->magic != shm_ring_magic)
+    {
+        throw runtime_error("ShmRing: " + name + " is not an initialized ring");
+    }
+}
+
+uint32_t ShmRing::slot_bytes() const
+{
+    return header->slot_bytes;
+}
+
+uint32_t ShmRing::slot_count() const
+{
+    return header->slot_count;
+}
+
+uint32_t ShmRing::instance() const
+{
+    return header->instance;
+}
+
+ShmRing::SlotHeader* ShmRing::slot(uint64_t position) const
+{
+    size_t index = static_cast<size_t>(position & (header->slot_count - 1));
+    char* slots = static_cast<char*>(base) + round_up(sizeof(Header), 64);
+    return reinterpret_cast<SlotHeader*>(slots + index * header->slot_stride);
+}
+
+void* ShmRing::try_claim(uint64_t& ticket)
+{
+    uint64_t position = header->write_position.load(memory_order_relaxed);
+    while (true)
+    {
+        SlotHeader* s = slot(position);
+        uint64_t sequence = s->sequence.load(memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence - position);
+        if (diff == 0)
+        {
+            // 槽空闲，和其他生产者竞争该位置
+            if (header->write_position.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+            {
+                ticket = position;
+                return reinterpret_cast<char*>(s) + sizeof(SlotHeader);
+            }
+        }
+        else if (diff < 0)
+        {
+            return nullptr;   // 消费者还没读完这一圈
+        }
+        else
+        {
+            position = header->write_position.load(memory_order_relaxed);
+        }
+    }
+}
+
+void* ShmRing::claim(uint64_t& ticket, int timeout_ms)
+{
+    auto deadline = chrono::steady_clock::now() + chrono::milliseconds(timeout_ms);
+    while (true)
+    {
+        uint32_t seen = header->space_signal.load();
+        void* payload = try_claim(ticket);
+        if (payload) return payload;
+
+        auto now = chrono::steady_clock::now();
+        if (now >= deadline) return nullptr;
+        int remaining = static_cast<int>(chrono::duration_cast<chrono::milliseconds>(deadline - now).count()) + 1;
+        wait(header->space_signal, seen, header->producers_waiting, false, remaining);
+    }
+}
+
+void ShmRing::publish(uint64_t ticket, uint32_t length, uint32_t tag, uint64_t user)
+{
+    if (length > header->slot_bytes)
+    {
+        cancel(ticket);
+        throw invalid_argument("ShmRing: message larger than slot");
+    }
+    SlotHeader* s = slot(ticket);
+    s->length = length;
+    s->tag = tag;
+    s->user = user;
+    s->sequence.store(ticket + 1, memory_order_release);
+    wake(header->data_signal, header->consumer_waiting, true);
+}
+
+void ShmRing::cancel(uint64_t ticket)
+{
+    SlotHeader* s = slot(ticket);
+    s->length = 0;
+    s->tag = cancelled_tag;
+    s->user = 0;
+    s->sequence.store(ticket + 1, memory_order_release);
+    wake(header->data_signal, header->consumer_waiting, true);
+}
+
+size_t ShmRing::peek(size_t max_count, vector<ShmSlot>& slots)
+{
+    slots.clear();
+    while (slots.size() < max_count)
+    {
+        uint64_t position = read_position + peeked;
+        SlotHeader* s = slot(position);
+        if (s->sequence.load(memory_order_acquire) != position + 1) break;
+
+        ShmSlot view;
+        view.data = reinterpret_cast<const char*>(s) + sizeof(SlotHeader);
+        view.length = s->length;
+        view.tag = s->tag;
+        view.user = s->user;
+        slots.push_back(view);
+        peeked++;
+    }
+    return slots.size();
+}
+
+void ShmRing::release(size_t count)
+{
+    if (count > peeked)
+    {
+        throw invalid_argument("ShmRing: releasing more slots than peeked");
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t position = read_position + i;
+        slot(position)->sequence.store(position + header->slot_count, memory_order_release);
+    }
+    read_position += count;
+    peeked -= count;
+    if (count > 0) wake(header->space_signal, header->producers_waiting, false);
+}
+
+bool ShmRing::wait_for_data(int timeout_ms)
+{
+    uint32_t seen = header->data_signal.load();
+    if (slot(read_position + peeked)->sequence.load(memory_order_acquire) == read_position + peeked + 1) return true;
+    wait(header->data_signal, seen, header->consumer_waiting, true, timeout_ms);
+    return slot(read_position + peeked)->sequence.load(memory_order_acquire) == read_position + peeked + 1;
+}
+
+// 先改信号字再检查等待者：等待方在读取 seen 之后才登记并检查队列，
+// 因此要么看到新数据，要么 futex/事件因信号字已变化而立即返回，不会丢失唤醒
+void ShmRing::wake(atomic<uint32_t>& signal, atomic<uint32_t>& waiters, bool data)
+{
+    signal.fetch_add(1);
+    uint32_t waiting = waiters.load();
+    if (waiting == 0) return;
+#ifdef _WIN32
+    // 每个已登记的等待者一个计数；若某个等待者随后发现信号字已变化而没有休眠，多出的计数只会让之后的一次等待提前返回
+    ReleaseSemaphore(data ? data_semaphore : space_semaphore, static_cast<LONG>(waiting), nullptr);
+#elif defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&signal), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+void ShmRing::wait(atomic<uint32_t>& signal, uint32_t seen, atomic<uint32_t>& waiters, bool data, int timeout_ms)
+{
+    waiters.fetch_add(1);
+    if (signal.load() == seen)
+    {
+#ifdef _WIN32
+        WaitForSingleObject(data ? data_semaphore : space_semaphore, static_cast<DWORD>(timeout_ms));
+#elif defined(__linux__)
+        timespec timeout{timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&signal), FUTEX_WAIT, seen, &timeout, nullptr, 0);
+#else
+        this_thread::sleep_for(chrono::milliseconds(1));
+#endif
+    }
+    waiters.fetch_sub(1);
+}
+
+#ifdef _WIN32
+
+void ShmRing::map_region(size_t bytes, bool create)
+{
+    string object_name = "Local\\" + name;
+    if (create)
+    {
+        uint64_t size = bytes;
+        mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32),
+                                     static_cast<DWORD>(size & 0xFFFFFFFFu), object_name.c_str());
+    }
+    else
+    {
+        mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, object_name.c_str());
+    }
+    if (!mapping)
+    {
+        throw runtime_error("ShmRing: cannot " + string(create ? "create " : "open ") + object_name);
+    }
+    base = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+    if (!base)
+    {
+        CloseHandle(mapping);
+        throw runtime_error("ShmRing: cannot map " + object_name);
+    }
+    mapped_bytes = bytes;
+
+    // 同名信号量在所有进程间共享
+    data_semaphore = CreateSemaphoreA(nullptr, 0, LONG_MAX, (object_name + "_data_sem").c_str());
+    space_semaphore = CreateSemaphoreA(nullptr, 0, LONG_MAX, (object_name + "_space_sem").c_str());
+}
+
+ShmRing::~ShmRing()
+{
+    if (base) UnmapViewOfFile(base);
+    if (mapping) CloseHandle(mapping);
+    if (data_semaphore) CloseHandle(data_semaphore);
+    if (space_semaphore) CloseHandle(space_semaphore);
+}
+
+#else
+
+void ShmRing::map_region(size_t bytes, bool create)
+{
+    string object_name = "/" + name;
+    int fd = create ? shm_open(object_name.c_str(), O_CREAT | O_RDWR, 0600) : shm_open(object_name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+    {
+        throw runtime_error("ShmRing: cannot " + string(create ? "create " : "open ") + object_name);
+    }
+
+    if (create)
+    {
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+        {
+            close(fd);
+            throw runtime_error("ShmRing: cannot resize " + object_name);
+        }
+    }
+    else
+    {
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header))
+        {
+            close(fd);
+            throw runtime_error("ShmRing: " + object_name + " is too small");
+        }
+        bytes = static_cast<size_t>(info.st_size);
+    }
+
+    void* address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED)
+    {
+        throw runtime_error("ShmRing: cannot map " + object_name);
+    }
+    base = address;
+    mapped_bytes = bytes;
+}
+
+ShmRing::~ShmRing()
+{
+    if (base) munmap(base, mapped_bytes);
+    if (owner) shm_unlink(("/" + name).c_str());
+}
+
+#endif
@@ -0,0 +1,91 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// 消费者看到的一个已发布的槽，data 直接指向共享内存，release 之前有效
+struct ShmSlot
+{
+    const void* data = nullptr;
+    uint32_t length = 0;
+    uint32_t tag = 0;
+    uint64_t user = 0;
+};
+
+// 共享内存中的定长槽环形队列 (多生产者 / 单消费者，无锁)。
+// 每个槽带一个序号：序号等于写位置时可写，等于写位置 + 1 时可读，读完后加上槽数交还生产者 (Vyukov 有界队列)。
+// 生产者先 claim 得到槽内指针直接写入数据 (零拷贝)，再 publish；消费者按顺序批量 peek 并 release。
+// 只在队列空/满时才需要同步：Linux 上用共享内存中的 futex 字，Windows 上用同名的信号量 (唤醒时按等待者个数释放，多个等待的生产者都能醒来)。
+// Linux 下共享内存位于 /dev/shm/<name>，Windows 下为 Local\<name> 命名映射
+class ShmRing
+{
+public:
+    // 作废槽的 tag，生产者不能把它用作普通的 tag
+    static constexpr uint32_t cancelled_tag = 0xFFFFFFFFu;
+
+    // 创建 (已存在同名队列时重新初始化)，slot_count 向上取整为 2 的幂；创建者析构时删除共享内存
+    ShmRing(const string& m_name, uint32_t slot_count, uint32_t slot_bytes);
+    // 打开由其他进程创建的队列
+    explicit ShmRing(const string& m_name);
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+    ~ShmRing();
+
+    uint32_t slot_bytes() const;
+    uint32_t slot_count() const;
+    // 创建时生成的随机标识：同名队列被删除后重新创建 (例如客户端重启) 会得到不同的值
+    uint32_t instance() const;
+
+    // ---- 生产者 (可多个进程/线程) ----
+    // 队列满时返回 nullptr；成功时返回槽内可写区域 (slot_bytes 字节)，ticket 交给 publish
+    void* try_claim(uint64_t& ticket);
+    // 队列满时等待至多 timeout_ms 毫秒，超时返回 nullptr
+    void* claim(uint64_t& ticket, int timeout_ms);
+    // length 超过槽大小时把该槽作为作废槽发布后再抛出 invalid_argument，槽不会一直停在已认领状态
+    void publish(uint64_t ticket, uint32_t length, uint32_t tag, uint64_t user);
+    // 放弃已认领的槽：以 cancelled_tag、长度 0 发布，消费者 peek 到后应直接跳过。
+    // 认领后写入失败时必须调用，否则消费者会一直停在这个序号上
+    void cancel(uint64_t ticket);
+
+    // ---- 消费者 (单个) ----
+    // 取出最多 max_count 个按顺序已发布的槽 (不拷贝数据)，返回个数
+    size_t peek(size_t max_count, vector<ShmSlot>& slots);
+    // 把最早 peek 到的 count 个槽交还生产者
+    void release(size_t count);
+    // 队列空时等待至多 timeout_ms 毫秒，有数据返回 true
+    bool wait_for_data(int timeout_ms);
+
+private:
+    struct Header;
+    struct SlotHeader;
+
+    string name;
+    bool owner = false;
+    void* base = nullptr;
+    size_t mapped_bytes = 0;
+    Header* header = nullptr;
+    uint64_t read_position = 0;     // 消费者私有：下一个要读的位置
+    uint64_t peeked = 0;            // 消费者私有：已 peek 未 release 的个数
+#ifdef _WIN32
+    void* mapping = nullptr;
+    void* data_semaphore = nullptr;
+    void* space_semaphore = nullptr;
+#endif
+
+    SlotHeader* slot(uint64_t position) const;
+    void map_region(size_t bytes, bool create);
+    void wake(atomic<uint32_t>& signal, atomic<uint32_t>& waiters, bool data);
+    void wait(atomic<uint32_t>& signal, uint32_t seen, atomic<uint32_t>& waiters, bool data, int timeout_ms);
+};
+
+#endif //SHM_RING_H
@@ -14,10 +14,21 @@
 
 using namespace std;
 
+// 数据在内存中的排布，shape 始终是逻辑形状 {通道, 高度, 宽度}：
+// CHW 为平面排布；CHWc 为通道分块排布 (批大小为 1 的 NCHWc)，按 [C / c][H][W][c] 存放，c 见 Layout.h；
+// HWC 为通道在最后的交错排布 (OpenCV 的原生排布)。一维张量标记为 HWC 表示它由 HWC 特征图按 [H][W][C] 展平
+enum class TensorLayout
+{
+    CHW,
+    CHWc,
+    HWC
+};
+
 struct Tensor
 {
     vector<float> data;
     vector<int> shape;// 存储每一维度的尺寸，例如 {通道, 高度, 宽度}
+    TensorLayout layout = TensorLayout::CHW;
 
     // 构造函数声明
     Tensor(vector<int, std::allocator<int>> m_shape) : shape(m_shape)
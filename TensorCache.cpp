@@ -0,0 +1,209 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "TensorCache.h"
+#include "Half.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    const char cache_magic[8] = {'C', 'N', 'N', 'T', 'C', 'A', 'C', 'H'};
+    const uint32_t cache_version = 1;
+    const uint32_t cache_alignment = 64;
+
+    // 文件中的数据类型编码 (取值即元素字节数)，与 PixelType 的声明顺序无关
+    uint32_t encode_dtype(PixelType dtype)
+    {
+        switch (dtype)
+        {
+        case PixelType::U8: return 1;
+        case PixelType::F16: return 2;
+        case PixelType::F32: return 4;
+        }
+        throw invalid_argument("TensorCache: unsupported dtype");
+    }
+
+    PixelType decode_dtype(uint32_t code)
+    {
+        switch (code)
+        {
+        case 1: return PixelType::U8;
+        case 2: return PixelType::F16;
+        case 4: return PixelType::F32;
+        }
+        throw runtime_error("TensorCache: unknown dtype code " + to_string(code));
+    }
+
+    uint64_t align_up(uint64_t value)
+    {
+        return (value + cache_alignment - 1) / cache_alignment * cache_alignment;
+    }
+}
+
+TensorCacheWriter::TensorCacheWriter(const string& path, PixelType m_dtype, int m_channels, int m_height, int m_width)
+    : out(path, ios::binary | ios::trunc), dtype(m_dtype), channels(m_channels), height(m_height), width(m_width)
+{
+    if (!out)
+    {
+        throw runtime_error("TensorCacheWriter: cannot create " + path);
+    }
+    if (channels <= 0 || height <= 0 || width <= 0)
+    {
+        throw invalid_argument("TensorCacheWriter: dimensions must be greater than zero");
+    }
+
+    uint64_t bytes = static_cast<uint64_t>(channels) * height * width * (encode_dtype(dtype));
+    record_stride = static_cast<uint32_t>(align_up(bytes));
+
+    // 先占位写文件头，finish() 时回填
+    TensorCacheHeader placeholder = {};
+    out.write(reinterpret_cast<const char*>(&placeholder), sizeof(placeholder));
+}
+
+void TensorCacheWriter::add(const string& name, const Tensor& tensor)
+{
+    if (finished)
+    {
+        throw logic_error("TensorCacheWriter: add after finish");
+    }
+    if (tensor.shape != vector<int>{channels, height, width})
+    {
+        throw invalid_argument("TensorCacheWriter: tensor shape mismatch for " + name);
+    }
+
+    vector<char> record(record_stride, 0);
+    size_t count = tensor.data.size();
+    if (dtype == PixelType::U8)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            float v = min(1.0f, max(0.0f, tensor.data[i]));
+            record[i] = static_cast<char>(static_cast<uint8_t>(lround(v * 255.0f)));
+        }
+    }
+    else if (dtype == PixelType::F16)
+    {
+        uint16_t* dst = reinterpret_cast<uint16_t*>(record.data());
+        for (size_t i = 0; i < count; i++)
+        {
+            dst[i] = float_to_half(tensor.data[i]);
+        }
+    }
+    else
+    {
+        memcpy(record.data(), tensor.data.data(), count * sizeof(float));
+    }
+
+    uint64_t offset = static_cast<uint64_t>(out.tellp());
+    out.write(record.data(), record.size());
+
+    index.push_back({offset, static_cast<uint32_t>(names.size()), static_cast<uint32_t>(name.size())});
+    names += name;
+}
+
+void TensorCacheWriter::finish()
+{
+    if (finished) return;
+    finished = true;
+
+    uint64_t index_offset = static_cast<uint64_t>(out.tellp());
+    out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(TensorCacheIndexEntry));
+    out.write(names.data(), names.size());
+
+    TensorCacheHeader header = {};
+    memcpy(header.magic, cache_magic, sizeof(cache_magic));
+    header.version = cache_version;
+    header.dtype = encode_dtype(dtype);
+    header.channels = channels;
+    header.height = height;
+    header.width = width;
+    header.record_stride = record_stride;
+    header.count = index.size();
+    header.data_offset = sizeof(TensorCacheHeader);
+    header.index_offset = index_offset;
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.flush();
+    if (!out)
+    {
+        throw runtime_error("TensorCacheWriter: write failed");
+    }
+}
+
+TensorCacheWriter::~TensorCacheWriter()
+{
+    try
+    {
+        finish();
+    }
+    catch (...)
+    {
+    }
+}
+
+TensorCacheReader::TensorCacheReader(const string& path) : file(make_unique<MappedFile>(path))
+{
+    if (file->size() < sizeof(TensorCacheHeader))
+    {
+        throw runtime_error("TensorCacheReader: file too small: " + path);
+    }
+    memcpy(&header, file->data(), sizeof(header));
+    if (memcmp(header.magic, cache_magic, sizeof(cache_magic)) != 0 || header.version != cache_version)
+    {
+        throw runtime_error("TensorCacheReader: not a tensor cache file: " + path);
+    }
+    decode_dtype(header.dtype);
+
+    uint64_t index_bytes = header.count * sizeof(TensorCacheIndexEntry);
+    if (header.index_offset + index_bytes > file->size())
+    {
+        throw runtime_error("TensorCacheReader: truncated index in " + path);
+    }
+    index = reinterpret_cast<const TensorCacheIndexEntry*>(file->data() + header.index_offset);
+    names = reinterpret_cast<const char*>(file->data() + header.index_offset + index_bytes);
+
+    uint64_t record_bytes = static_cast<uint64_t>(header.channels) * header.height * header.width * header.dtype;
+    for (size_t i = 0; i < size(); i++)
+    {
+        if (index[i].data_offset + record_bytes > header.index_offset)
+        {
+            throw runtime_error("TensorCacheReader: record out of range in " + path);
+        }
+    }
+}
+
+PixelType TensorCacheReader::dtype() const
+{
+    return decode_dtype(header.dtype);
+}
+
+string TensorCacheReader::name(size_t i) const
+{
+    if (i >= size())
+    {
+        throw out_of_range("TensorCacheReader: index out of range");
+    }
+    const char* end = reinterpret_cast<const char*>(file->data() + file->size());
+    if (names + index[i].name_offset + index[i].name_length > end)
+    {
+        throw runtime_error("TensorCacheReader: name out of range");
+    }
+    return string(names + index[i].name_offset, index[i].name_length);
+}
+
+ImageView TensorCacheReader::view(size_t i) const
+{
+    if (i >= size())
+    {
+        throw out_of_range("TensorCacheReader: index out of range");
+    }
+    return ImageView(file->data() + index[i].data_offset, dtype(), PixelLayout::CHW,
+                     static_cast<int>(header.channels), static_cast<int>(header.height), static_cast<int>(header.width));
+}
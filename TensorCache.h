@@ -0,0 +1,90 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef TENSOR_CACHE_H
+#define TENSOR_CACHE_H
+
+#include "ImageView.h"
+#include "MappedFile.h"
+#include "Tensor.h"
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// 预处理后张量缓存文件格式 (小端):
+//   文件头 64 字节: "CNNTCACH", 版本, 数据类型, C, H, W, 单条记录字节数, 条数, 数据区偏移, 索引区偏移
+//   数据区: 每条记录为一个 CHW 张量，起始地址按 64 字节对齐，可直接映射使用
+//   索引区: 每条 {uint64 数据偏移, uint32 名称偏移, uint32 名称长度}，其后为名称字符串
+struct TensorCacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t dtype;
+    uint32_t channels;
+    uint32_t height;
+    uint32_t width;
+    uint32_t record_stride;
+    uint64_t count;
+    uint64_t data_offset;
+    uint64_t index_offset;
+    uint8_t reserved[8];
+};
+
+static_assert(sizeof(TensorCacheHeader) == 64, "TensorCacheHeader must stay 64 bytes");
+
+struct TensorCacheIndexEntry
+{
+    uint64_t data_offset;
+    uint32_t name_offset;
+    uint32_t name_length;
+};
+
+// 顺序写入预处理后的张量，finish() 时写出索引并回填文件头
+class TensorCacheWriter
+{
+private:
+    ofstream out;
+    PixelType dtype;
+    int channels, height, width;
+    uint32_t record_stride;
+    vector<TensorCacheIndexEntry> index;
+    string names;
+    bool finished = false;
+
+public:
+    TensorCacheWriter(const string& path, PixelType m_dtype, int m_channels, int m_height, int m_width);
+
+    // 追加一个 [0, 1] 范围的 CHW 张量；U8 时量化为 round(v * 255)
+    void add(const string& name, const Tensor& tensor);
+    void finish();
+    size_t size() const { return index.size(); }
+
+    ~TensorCacheWriter();
+};
+
+// 映射缓存文件，按下标提供指向文件内容的零拷贝视图，可直接交给 CNN::predict(const ImageView&)
+class TensorCacheReader
+{
+private:
+    unique_ptr<MappedFile> file;
+    TensorCacheHeader header;
+    const TensorCacheIndexEntry* index = nullptr;
+    const char* names = nullptr;
+
+public:
+    explicit TensorCacheReader(const string& path);
+
+    size_t size() const { return static_cast<size_t>(header.count); }
+    vector<int> shape() const { return {static_cast<int>(header.channels), static_cast<int>(header.height), static_cast<int>(header.width)}; }
+    PixelType dtype() const;
+
+    string name(size_t i) const;
+    ImageView view(size_t i) const;
+};
+
+#endif //TENSOR_CACHE_H
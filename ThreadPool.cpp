@@ -0,0 +1,64 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "ThreadPool.h"
+#include <algorithm>
+
+using namespace std;
+
+ThreadPool::ThreadPool(size_t thread_count)
+{
+    if (thread_count == 0)
+    {
+        thread_count = max(1u, thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < thread_count; i++)
+    {
+        workers.emplace_back(&ThreadPool::worker_loop, this);
+    }
+}
+
+void ThreadPool::worker_loop()
+{
+    while (true)
+    {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(mtx);
+            cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::submit(function<void()> task)
+{
+    {
+        lock_guard<mutex> lock(mtx);
+        tasks.push_back(std::move(task));
+    }
+    cv.notify_one();
+}
+
+ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
@@ -0,0 +1,45 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// 固定线程数的简单线程池，任务按提交顺序执行
+class ThreadPool
+{
+private:
+    vector<thread> workers;
+    deque<function<void()>> tasks;
+    mutex mtx;
+    condition_variable cv;
+    bool stopping = false;
+
+    void worker_loop();
+
+public:
+    // thread_count 为 0 时使用硬件并发数
+    explicit ThreadPool(size_t thread_count = 0);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(function<void()> task);
+    size_t size() const { return workers.size(); }
+
+    // 进程内共享的默认线程池 (硬件并发数个线程)
+    static ThreadPool& shared();
+
+    // 等待已提交的任务全部执行完后结束线程
+    ~ThreadPool();
+};
+
+#endif //THREAD_POOL_H
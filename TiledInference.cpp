@@ -0,0 +1,148 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "TiledInference.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    // 半开区间 [begin, end)
+    struct Span
+    {
+        int begin = 0, end = 0;
+        int size() const { return end - begin; }
+    };
+
+    // 输出区间 out 在本层输入上需要的区间 (未截断)，越过 [0, in_size) 的部分即为填充
+    Span input_span(const Span& out, int kernel, int stride, int pad)
+    {
+        return {out.begin * stride - pad, (out.end - 1) * stride - pad + kernel};
+    }
+
+    Span clamp_span(const Span& span, int size)
+    {
+        return {max(0, span.begin), min(size, span.end)};
+    }
+}
+
+TiledRunner::TiledRunner(const CNN& cnn, int m_tile_h, int m_tile_w) : tile_h(m_tile_h), tile_w(m_tile_w)
+{
+    if (tile_h <= 0 || tile_w <= 0)
+    {
+        throw invalid_argument("TiledRunner: tile size must be greater than zero");
+    }
+
+    for (const auto& m_layer : cnn.get_layers())
+    {
+        spatial_window window;
+        if (!m_layer->get_spatial_window(window)) break;
+        prefix.push_back(m_layer);
+        windows.push_back(window);
+    }
+    if (prefix.empty())
+    {
+        throw invalid_argument("TiledRunner: network does not start with spatial layers");
+    }
+}
+
+vector<vector<int>> TiledRunner::layer_shapes(const ImageView& image) const
+{
+    vector<vector<int>> shapes = {image.shape()};
+    for (const auto& m_layer : prefix)
+    {
+        shapes.push_back(m_layer->get_output_shape(shapes.back()));
+    }
+    return shapes;
+}
+
+void TiledRunner::run(const ImageView& image, const tile_sink& sink, TiledStats* stats) const
+{
+    image.validate();
+
+    size_t n = prefix.size();
+    vector<vector<int>> shapes = layer_shapes(image);
+    int out_h = shapes[n][1], out_w = shapes[n][2];
+
+    TiledStats local_stats;
+    double input_pixels_read = 0.0;
+
+    vector<Span> rows(n + 1), cols(n + 1);
+    vector<int> pad_top(n), pad_left(n);
+
+    for (int ty = 0; ty < out_h; ty += tile_h)
+    {
+        for (int tx = 0; tx < out_w; tx += tile_w)
+        {
+            // 1. 从输出分块逐层向前推出每层所需的输入区间及该区间外侧的填充量
+            rows[n] = {ty, min(out_h, ty + tile_h)};
+            cols[n] = {tx, min(out_w, tx + tile_w)};
+            for (size_t l = n; l-- > 0;)
+            {
+                const spatial_window& w = windows[l];
+                Span need_rows = input_span(rows[l + 1], w.kernel_h, w.stride_h, w.pad_h);
+                Span need_cols = input_span(cols[l + 1], w.kernel_w, w.stride_w, w.pad_w);
+                rows[l] = clamp_span(need_rows, shapes[l][1]);
+                cols[l] = clamp_span(need_cols, shapes[l][2]);
+                pad_top[l] = rows[l].begin - need_rows.begin;
+                pad_left[l] = cols[l].begin - need_cols.begin;
+            }
+
+            // 2. 只读取本块需要的输入区域 (含 halo)
+            Tensor current({image.channels, rows[0].size(), cols[0].size()});
+            for (int c = 0; c < image.channels; c++)
+            {
+                for (int y = 0; y < rows[0].size(); y++)
+                {
+                    float* dst = current.data.data() + (c * rows[0].size() + y) * cols[0].size();
+                    image.read_row(c, rows[0].begin + y, cols[0].begin, cols[0].size(), dst);
+                }
+            }
+            input_pixels_read += static_cast<double>(rows[0].size()) * cols[0].size();
+            local_stats.peak_tile_floats = max(local_stats.peak_tile_floats, current.data.size());
+
+            // 3. 整块穿过前缀的每一层
+            for (size_t l = 0; l < n; l++)
+            {
+                Tensor next;
+                prefix[l]->forward_region(current, next, pad_top[l], pad_left[l], rows[l + 1].size(), cols[l + 1].size());
+                current = std::move(next);
+                local_stats.peak_tile_floats = max(local_stats.peak_tile_floats, current.data.size());
+            }
+
+            sink(current, ty, tx);
+            local_stats.tiles++;
+        }
+    }
+
+    if (stats)
+    {
+        local_stats.halo_overhead = input_pixels_read / (static_cast<double>(image.height) * image.width) - 1.0;
+        *stats = local_stats;
+    }
+}
+
+Tensor TiledRunner::run(const ImageView& image, TiledStats* stats) const
+{
+    image.validate();
+
+    Tensor result(output_shape(image));
+    int out_c = result.shape[0], out_h = result.shape[1], out_w = result.shape[2];
+
+    run(image, [&](const Tensor& tile, int y0, int x0) {
+        int block_h = tile.shape[1], block_w = tile.shape[2];
+        for (int c = 0; c < out_c; c++)
+        {
+            for (int y = 0; y < block_h; y++)
+            {
+                const float* src = tile.data.data() + (c * block_h + y) * block_w;
+                float* dst = result.data.data() + (c * out_h + y0 + y) * out_w + x0;
+                copy(src, src + block_w, dst);
+            }
+        }
+    }, stats);
+    return result;
+}
@@ -0,0 +1,56 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef TILED_INFERENCE_H
+#define TILED_INFERENCE_H
+
+#include "CNN.h"
+#include "ImageView.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+struct TiledStats
+{
+    int tiles = 0;
+    size_t peak_tile_floats = 0;   // 单个分块在各层中出现过的最大张量元素数
+    double halo_overhead = 0.0;    // 各分块读取的输入像素总数 / 输入像素数 - 1
+};
+
+// 对 CNN 开头连续的空间层 (Conv / maxPooling / 逐元素层) 做分块推理。
+// 输出按 tile_h x tile_w 切块，根据各层的核、步长和填充向前推出每块所需的输入区域 (含重叠的 halo)，
+// 每块独立地穿过整个前缀后交给调用方；图像边界处按原有填充处理，内部块使用真实邻域，
+// 因此拼接结果与整图推理完全一致。
+// 中间激活只按分块大小分配：逐块回调的 run 峰值内存与图像尺寸无关；返回整个 Tensor 的 run 另需一份完整输出
+class TiledRunner
+{
+private:
+    vector<shared_ptr<layer>> prefix;
+    vector<spatial_window> windows;
+    int tile_h, tile_w;
+
+    // 输入及前缀每层输出的形状
+    vector<vector<int>> layer_shapes(const ImageView& image) const;
+
+public:
+    // tile 为 CHW 的 {C, h, w} 输出块，(y0, x0) 为其左上角在完整输出中的位置；tile 只在回调期间有效
+    using tile_sink = function<void(const Tensor& tile, int y0, int x0)>;
+
+    // tile_h/tile_w 为前缀最终输出特征图上的分块尺寸
+    TiledRunner(const CNN& cnn, int m_tile_h, int m_tile_w);
+
+    // image 可以是任意大小的外部缓冲区 (例如内存映射的大图)；按行优先顺序把每个输出块交给 sink，不分配完整输出
+    void run(const ImageView& image, const tile_sink& sink, TiledStats* stats = nullptr) const;
+
+    // 拼接所有输出块，返回前缀最终输出 {C, H', W'}
+    Tensor run(const ImageView& image, TiledStats* stats = nullptr) const;
+
+    vector<int> output_shape(const ImageView& image) const { return layer_shapes(image).back(); }
+
+    size_t prefix_size() const { return prefix.size(); }
+};
+
+#endif //TILED_INFERENCE_H
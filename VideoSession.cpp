@@ -0,0 +1,277 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "VideoSession.h"
+#include "Layout.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    using session_clock = chrono::steady_clock;
+
+    // 半开矩形 [y0, y1) x [x0, x1)
+    struct Rect
+    {
+        int y0 = 0, y1 = 0, x0 = 0, x1 = 0;
+        bool empty() const { return y0 >= y1 || x0 >= x1; }
+        int area() const { return (y1 - y0) * (x1 - x0); }
+    };
+
+    int floor_div(int a, int b)
+    {
+        return a >= 0 ? a / b : -((-a + b - 1) / b);
+    }
+
+    // 合并互相重叠的矩形，避免同一位置被重复计算
+    void merge_overlapping(vector<Rect>& rects)
+    {
+        bool merged = true;
+        while (merged)
+        {
+            merged = false;
+            for (size_t i = 0; i < rects.size() && !merged; i++)
+            {
+                for (size_t j = i + 1; j < rects.size(); j++)
+                {
+                    Rect& a = rects[i];
+                    const Rect& b = rects[j];
+                    if (a.y0 < b.y1 && b.y0 < a.y1 && a.x0 < b.x1 && b.x0 < a.x1)
+                    {
+                        a = {min(a.y0, b.y0), max(a.y1, b.y1), min(a.x0, b.x0), max(a.x1, b.x1)};
+                        rects.erase(rects.begin() + j);
+                        merged = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // 将 source 中的矩形区域 (所有通道) 拷贝为一个独立张量
+    Tensor crop(const Tensor& source, const Rect& r)
+    {
+        int channels = source.shape[0], height = source.shape[1], width = source.shape[2];
+        int h = r.y1 - r.y0, w = r.x1 - r.x0;
+        Tensor result({channels, h, w});
+        for (int c = 0; c < channels; c++)
+        {
+            for (int y = 0; y < h; y++)
+            {
+                const float* src = source.data.data() + (c * height + r.y0 + y) * width + r.x0;
+                copy(src, src + w, result.data.data() + (c * h + y) * w);
+            }
+        }
+        return result;
+    }
+
+    // crop 的逆操作：把 block 写回 target 的矩形区域
+    void paste(const Tensor& block, Tensor& target, const Rect& r)
+    {
+        int channels = target.shape[0], height = target.shape[1], width = target.shape[2];
+        int h = r.y1 - r.y0, w = r.x1 - r.x0;
+        for (int c = 0; c < channels; c++)
+        {
+            for (int y = 0; y < h; y++)
+            {
+                const float* src = block.data.data() + (c * h + y) * w;
+                copy(src, src + w, target.data.data() + (c * height + r.y0 + y) * width + r.x0);
+            }
+        }
+    }
+}
+
+void VideoFrameStats::print(ostream& os) const
+{
+    os << "frame: " << dirty_blocks << "/" << total_blocks << " blocks changed, skipped "
+       << skipped_fraction * 100.0 << "% of work, " << ms << " ms" << endl;
+}
+
+VideoSession::VideoSession(const CNN& cnn, const VideoSessionConfig& m_config) : config(m_config)
+{
+    if (config.block <= 0)
+    {
+        throw invalid_argument("VideoSession: block size must be greater than zero");
+    }
+
+    const vector<shared_ptr<layer>>& layers = cnn.get_layers();
+    size_t i = 0;
+    for (; i < layers.size(); i++)
+    {
+        spatial_window window;
+        if (!layers[i]->get_spatial_window(window)) break;
+        prefix.push_back(layers[i]);
+        windows.push_back(window);
+        mixes_channels.push_back(dynamic_pointer_cast<Conv>(layers[i]) != nullptr);
+    }
+    tail.assign(layers.begin() + i, layers.end());
+    if (prefix.empty())
+    {
+        throw invalid_argument("VideoSession: network does not start with spatial layers");
+    }
+}
+
+void VideoSession::run_full(const Tensor& frame)
+{
+    activations.assign(prefix.size() + 1, Tensor());
+    activations[0] = frame;
+    for (size_t l = 0; l < prefix.size(); l++)
+    {
+        prefix[l]->forward(activations[l], activations[l + 1]);
+        // 增量更新按 CHW 裁剪与拼接缓存的特征图
+        if (activations[l + 1].layout != TensorLayout::CHW) activations[l + 1] = to_planar(activations[l + 1]);
+    }
+    run_tail();
+    primed = true;
+}
+
+void VideoSession::run_tail()
+{
+    Tensor current = activations.back();
+    for (const auto& m_layer : tail)
+    {
+        run_layer(*m_layer, current);
+    }
+    last_output = std::move(current);
+}
+
+Tensor VideoSession::process(const Tensor& frame, VideoFrameStats* stats)
+{
+    auto start = session_clock::now();
+    if (frame.shape.size() != 3)
+    {
+        throw invalid_argument("VideoSession: frame must be a CHW tensor");
+    }
+
+    int channels = frame.shape[0], height = frame.shape[1], width = frame.shape[2];
+    int block = config.block;
+    int blocks_y = (height + block - 1) / block, blocks_x = (width + block - 1) / block;
+
+    VideoFrameStats local_stats;
+    local_stats.total_blocks = blocks_y * blocks_x;
+
+    if (!primed || activations[0].shape != frame.shape)
+    {
+        run_full(frame);
+        local_stats.dirty_blocks = local_stats.total_blocks;
+        local_stats.ms = chrono::duration<double, milli>(session_clock::now() - start).count();
+        if (stats) *stats = local_stats;
+        return last_output;
+    }
+
+    // 1. 按块比较新帧与缓存的输入，同一块行上相邻的改变块合并为一个矩形
+    const Tensor& cached = activations[0];
+    vector<Rect> dirty;
+    for (int by = 0; by < blocks_y; by++)
+    {
+        int y0 = by * block, y1 = min(height, y0 + block);
+        Rect run;
+        bool in_run = false;
+        for (int bx = 0; bx <= blocks_x; bx++)
+        {
+            bool changed = false;
+            int x0 = bx * block, x1 = min(width, x0 + block);
+            for (int c = 0; c < channels && bx < blocks_x && !changed; c++)
+            {
+                for (int y = y0; y < y1 && !changed; y++)
+                {
+                    const float* a = frame.data.data() + (c * height + y) * width;
+                    const float* b = cached.data.data() + (c * height + y) * width;
+                    for (int x = x0; x < x1; x++)
+                    {
+                        if (fabs(a[x] - b[x]) > config.tolerance)
+                        {
+                            changed = true;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            if (changed)
+            {
+                local_stats.dirty_blocks++;
+                if (!in_run) run = {y0, y1, x0, x1};
+                run.x1 = x1;
+                in_run = true;
+            }
+            else if (in_run)
+            {
+                dirty.push_back(run);
+                in_run = false;
+            }
+        }
+    }
+
+    if (local_stats.dirty_blocks == 0)
+    {
+        local_stats.skipped_fraction = 1.0;
+        local_stats.ms = chrono::duration<double, milli>(session_clock::now() - start).count();
+        if (stats) *stats = local_stats;
+        return last_output;
+    }
+    if (local_stats.dirty_blocks > config.full_threshold * local_stats.total_blocks)
+    {
+        run_full(frame);
+        local_stats.ms = chrono::duration<double, milli>(session_clock::now() - start).count();
+        if (stats) *stats = local_stats;
+        return last_output;
+    }
+
+    // 只更新改变的块；未超过 tolerance 的块保留旧值，与沿用的旧结果保持一致
+    for (const Rect& r : dirty) paste(crop(frame, r), activations[0], r);
+
+    // 2. 逐层把脏矩形映射到输出上受影响的范围，只重算这些区域
+    double total_work = 0.0, done_work = 0.0;
+    for (size_t l = 0; l < prefix.size(); l++)
+    {
+        const spatial_window& w = windows[l];
+        const vector<int>& in_shape = activations[l].shape;
+        const vector<int>& out_shape = activations[l + 1].shape;
+        double cost = static_cast<double>(w.kernel_h) * w.kernel_w * (mixes_channels[l] ? in_shape[0] : 1) * out_shape[0];
+        total_work += cost * out_shape[1] * out_shape[2];
+
+        // 输出 o 覆盖输入 [o * s - p, o * s - p + k)，与脏区间 [a, b) 相交即需重算
+        vector<Rect> next_dirty;
+        for (const Rect& r : dirty)
+        {
+            Rect out;
+            out.y0 = max(0, floor_div(r.y0 - w.kernel_h + w.pad_h, w.stride_h) + 1);
+            out.y1 = min(out_shape[1], floor_div(r.y1 - 1 + w.pad_h, w.stride_h) + 1);
+            out.x0 = max(0, floor_div(r.x0 - w.kernel_w + w.pad_w, w.stride_w) + 1);
+            out.x1 = min(out_shape[2], floor_div(r.x1 - 1 + w.pad_w, w.stride_w) + 1);
+            if (!out.empty()) next_dirty.push_back(out);
+        }
+        merge_overlapping(next_dirty);
+
+        for (const Rect& out : next_dirty)
+        {
+            // 重算 out 所需的输入区域，越过特征图边界的部分按原有填充处理
+            int need_y0 = out.y0 * w.stride_h - w.pad_h, need_x0 = out.x0 * w.stride_w - w.pad_w;
+            Rect in;
+            in.y0 = max(0, need_y0);
+            in.y1 = min(in_shape[1], (out.y1 - 1) * w.stride_h - w.pad_h + w.kernel_h);
+            in.x0 = max(0, need_x0);
+            in.x1 = min(in_shape[2], (out.x1 - 1) * w.stride_w - w.pad_w + w.kernel_w);
+
+            Tensor region;
+            prefix[l]->forward_region(crop(activations[l], in), region, in.y0 - need_y0, in.x0 - need_x0,
+                                      out.y1 - out.y0, out.x1 - out.x0);
+            paste(region, activations[l + 1], out);
+            done_work += cost * out.area();
+        }
+        dirty = std::move(next_dirty);
+    }
+
+    run_tail();
+
+    local_stats.skipped_fraction = total_work > 0 ? 1.0 - done_work / total_work : 0.0;
+    local_stats.ms = chrono::duration<double, milli>(session_clock::now() - start).count();
+    if (stats) *stats = local_stats;
+    return last_output;
+}
@@ -0,0 +1,62 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef VIDEO_SESSION_H
+#define VIDEO_SESSION_H
+
+#include "CNN.h"
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+struct VideoSessionConfig
+{
+    int block = 8;                  // 输入差分的块边长 (像素)
+    float tolerance = 0.0f;         // 块内任一元素变化超过该值才算改变；0 表示逐位比较，结果与整帧推理完全一致
+    float full_threshold = 0.5f;    // 改变的块超过该比例时直接整帧重算
+};
+
+struct VideoFrameStats
+{
+    int dirty_blocks = 0;
+    int total_blocks = 0;
+    double skipped_fraction = 0.0;  // 被跳过的空间层计算量占整帧计算量的比例 (按乘加次数加权)
+    double ms = 0.0;
+
+    void print(ostream& os) const;
+};
+
+// 视频增量推理：缓存上一帧在每个空间层 (Conv / maxPooling / 逐元素层) 的输入输出，
+// 新帧按块与缓存的输入比较，改变的块作为脏矩形沿各层的感受野向后传播，
+// 每层只用 forward_region 重算受影响的输出区域并写回缓存，其余位置直接沿用上一帧的结果；
+// flatten 之后的非空间层体量很小，只要有改变就整体重算。
+// 设置 tolerance 时未超过阈值的块保留旧值，缓存始终与已输出的结果一致，误差不会逐帧累积
+class VideoSession
+{
+private:
+    vector<shared_ptr<layer>> prefix;     // 开头连续的空间层
+    vector<spatial_window> windows;
+    vector<bool> mixes_channels;          // Conv 的每个输出要累加所有输入通道，用于估算计算量
+    vector<shared_ptr<layer>> tail;       // 其余层
+    VideoSessionConfig config;
+
+    vector<Tensor> activations;           // activations[0] 为缓存的输入，activations[l + 1] 为第 l 层的输出
+    Tensor last_output;
+    bool primed = false;
+
+    void run_full(const Tensor& frame);
+    void run_tail();
+
+public:
+    VideoSession(const CNN& cnn, const VideoSessionConfig& m_config = VideoSessionConfig());
+
+    // frame 为 CHW 图像，尺寸与上一帧不同时自动整帧重算
+    Tensor process(const Tensor& frame, VideoFrameStats* stats = nullptr);
+
+    // 丢弃缓存，下一帧整帧计算 (例如切换镜头之后)
+    void reset() { primed = false; }
+};
+
+#endif //VIDEO_SESSION_H
@@ -0,0 +1,168 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "VideoStream.h"
+#include "BoundedQueue.h"
+#include "Preprocess.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+    using stream_clock = chrono::steady_clock;
+
+    double elapsed_ms(stream_clock::time_point start)
+    {
+        return chrono::duration<double, milli>(stream_clock::now() - start).count();
+    }
+
+    struct StreamFrame
+    {
+        int index = 0;
+        stream_clock::time_point started;
+        cv::Mat image;
+        Tensor input;
+    };
+
+    // 按丢帧策略把帧交给下一阶段，返回 false 表示下游已关闭
+    bool hand_off(BoundedQueue<StreamFrame>& queue, StreamFrame frame, FrameDropPolicy policy, int& dropped)
+    {
+        if (policy == FrameDropPolicy::Block)
+        {
+            return queue.push(std::move(frame));
+        }
+        if (policy == FrameDropPolicy::DropOldest)
+        {
+            bool was_dropped = false;
+            bool ok = queue.push_drop_oldest(std::move(frame), was_dropped);
+            if (was_dropped) dropped++;
+            return ok;
+        }
+        if (queue.try_push(std::move(frame))) return true;
+        if (queue.is_closed()) return false;   // 队列已关闭不算丢帧，让上游退出
+        dropped++;
+        return true;
+    }
+}
+
+void VideoStreamStats::print(ostream& os) const
+{
+    double seconds = wall_ms / 1000.0;
+    os << "frames: " << decoded << " decoded, " << inferred << " inferred, dropped "
+       << dropped_before_preprocess << " before preprocess / " << dropped_before_infer << " before infer\n";
+    os << "stage latency (ms/frame): decode " << (decoded > 0 ? decode_ms / decoded : 0.0)
+       << ", preprocess " << (decoded - dropped_before_preprocess > 0 ? preprocess_ms / (decoded - dropped_before_preprocess) : 0.0)
+       << ", infer " << (inferred > 0 ? infer_ms / inferred : 0.0) << "\n";
+    os << "end-to-end latency " << (inferred > 0 ? latency_ms / inferred : 0.0) << " ms, achieved "
+       << (seconds > 0 ? inferred / seconds : 0.0) << " fps over " << wall_ms << " ms" << endl;
+}
+
+VideoStream::VideoStream(CNN& m_cnn, const VideoStreamConfig& m_config) : cnn(m_cnn), config(m_config)
+{
+    if (config.queue_capacity <= 0)
+    {
+        throw invalid_argument("VideoStream: queue_capacity must be greater than zero");
+    }
+    if (config.input_h <= 0 || config.input_w <= 0)
+    {
+        throw invalid_argument("VideoStream: input size must be greater than zero");
+    }
+}
+
+VideoStreamStats VideoStream::run(const string& source, const function<void(const VideoFrameResult&)>& on_result)
+{
+    cv::VideoCapture capture;
+    bool is_device = !source.empty() && all_of(source.begin(), source.end(), [](unsigned char ch) { return isdigit(ch); });
+    if (is_device) capture.open(stoi(source));
+    else capture.open(source);
+    if (!capture.isOpened())
+    {
+        throw runtime_error("Could not open video source: " + source);
+    }
+
+    VideoStreamStats stats;
+    BoundedQueue<StreamFrame> decoded(config.queue_capacity);
+    BoundedQueue<StreamFrame> prepared(config.queue_capacity);
+    auto start = stream_clock::now();
+
+    // 阶段 1: 解码
+    thread decoder([&] {
+        for (int index = 0; config.max_frames <= 0 || index < config.max_frames; index++)
+        {
+            StreamFrame frame;
+            frame.index = index;
+            frame.started = stream_clock::now();
+            if (!capture.read(frame.image)) break;
+            stats.decode_ms += elapsed_ms(frame.started);
+            stats.decoded++;
+            if (!hand_off(decoded, std::move(frame), config.policy, stats.dropped_before_preprocess)) break;
+        }
+        decoded.close();
+    });
+
+    // 阶段 2: 缩放并转换为网络输入；出错时关闭两个队列让解码与推理退出，异常在 run 的末尾重新抛出
+    exception_ptr preprocess_error;
+    thread preprocessor([&] {
+        try
+        {
+            StreamFrame frame;
+            while (decoded.pop(frame))
+            {
+                auto stage_start = stream_clock::now();
+                image_to_tensor(frame.image, config.input_h, config.input_w, frame.input);
+                frame.image.release();
+                stats.preprocess_ms += elapsed_ms(stage_start);
+                if (!hand_off(prepared, std::move(frame), config.policy, stats.dropped_before_infer)) break;
+            }
+        }
+        catch (...)
+        {
+            preprocess_error = current_exception();
+            decoded.close();
+        }
+        prepared.close();
+    });
+
+    // 阶段 3: 推理 (当前线程)
+    try
+    {
+        StreamFrame frame;
+        while (prepared.pop(frame))
+        {
+            auto stage_start = stream_clock::now();
+            Tensor output = cnn.predict(frame.input);
+            stats.infer_ms += elapsed_ms(stage_start);
+
+            VideoFrameResult result;
+            result.index = frame.index;
+            result.p_face = output.data[0];
+            result.p_background = output.data[1];
+            result.latency_ms = elapsed_ms(frame.started);
+            stats.latency_ms += result.latency_ms;
+            stats.inferred++;
+            if (on_result) on_result(result);
+        }
+    }
+    catch (...)
+    {
+        // 关闭队列让上游线程退出后再向外抛出
+        decoded.close();
+        prepared.close();
+        decoder.join();
+        preprocessor.join();
+        throw;
+    }
+
+    decoder.join();
+    preprocessor.join();
+    if (preprocess_error) rethrow_exception(preprocess_error);
+    stats.wall_ms = elapsed_ms(start);
+    return stats;
+}
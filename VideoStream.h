@@ -0,0 +1,70 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef VIDEO_STREAM_H
+#define VIDEO_STREAM_H
+
+#include "CNN.h"
+#include <functional>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+// 下游跟不上时的处理方式
+enum class FrameDropPolicy
+{
+    Block,       // 不丢帧，上游阻塞等待 (处理视频文件)
+    DropOldest,  // 丢弃队列中最旧的帧，下游总是处理最新的帧 (实时摄像头)
+    DropNewest   // 丢弃刚产生的帧
+};
+
+struct VideoStreamConfig
+{
+    int queue_capacity = 2;   // 相邻两阶段之间的队列容量 (帧)
+    FrameDropPolicy policy = FrameDropPolicy::Block;
+    int input_h = 128;        // 网络输入尺寸
+    int input_w = 128;
+    int max_frames = 0;       // 最多读取的帧数，0 表示读到结束
+};
+
+struct VideoFrameResult
+{
+    int index = 0;            // 帧在视频中的序号
+    float p_face = 0.0f;
+    float p_background = 0.0f;
+    double latency_ms = 0.0;  // 从开始解码到推理完成
+};
+
+struct VideoStreamStats
+{
+    int decoded = 0;
+    int inferred = 0;
+    int dropped_before_preprocess = 0;
+    int dropped_before_infer = 0;
+    double wall_ms = 0.0;
+    double decode_ms = 0.0;       // 各阶段累计耗时，print 时按帧平均
+    double preprocess_ms = 0.0;
+    double infer_ms = 0.0;
+    double latency_ms = 0.0;      // 端到端延迟之和
+
+    void print(ostream& os) const;
+};
+
+// 视频流推理：解码 (cv::VideoCapture)、预处理 (image_to_tensor) 和 CNN::predict 各占一个线程，
+// 阶段之间用有界队列交接，三者可以同时处理相邻的帧；下游跟不上时按 policy 阻塞或丢帧
+class VideoStream
+{
+private:
+    CNN& cnn;
+    VideoStreamConfig config;
+
+public:
+    VideoStream(CNN& m_cnn, const VideoStreamConfig& m_config);
+
+    // source 为视频文件路径，或表示摄像头编号的纯数字；每推理完一帧调用一次 on_result (推理线程)
+    VideoStreamStats run(const string& source, const function<void(const VideoFrameResult&)>& on_result);
+};
+
+#endif //VIDEO_STREAM_H
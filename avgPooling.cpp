@@ -0,0 +1,70 @@
+//
+// Created on 2026/10/19.
+//
+
+#include "avgPooling.h"
+#include "Layout.h"
+#include <stdexcept>
+
+using namespace std;
+
+std::vector<int> avgPooling::get_output_shape(const std::vector<int>& input_shape) const
+{
+    return pooled_shape(input_shape, params);
+}
+
+bool avgPooling::get_spatial_window(spatial_window& window) const
+{
+    pooled_window(params, window);
+    return true;
+}
+
+void avgPooling::forward(const Tensor& input, Tensor& output)
+{
+    vector<int> output_shape = get_output_shape(input.shape);
+    pool_forward(input, output, params, pool_kind::average, params.pad_h, params.pad_w, output_shape[1], output_shape[2]);
+}
+
+void avgPooling::forward_region(const Tensor& input, Tensor& output, int pad_top, int pad_left, int out_h, int out_w)
+{
+    pool_forward(input, output, params, pool_kind::average, pad_top, pad_left, out_h, out_w);
+}
+
+std::vector<int> globalAvgPooling::get_output_shape(const std::vector<int>& input_shape) const
+{
+    if (input_shape.size() != 3)
+    {
+        throw invalid_argument("globalAvgPooling: expects [C, H, W] input");
+    }
+    return {input_shape[0], 1, 1};
+}
+
+void globalAvgPooling::forward(const Tensor& input, Tensor& output)
+{
+    output.shape = get_output_shape(input.shape);
+    output.data.assign(input.shape[0], 0.0f);
+    output.layout = TensorLayout::CHW;
+
+    int channels = input.shape[0];
+    size_t plane = static_cast<size_t>(input.shape[1]) * input.shape[2];
+    if (plane == 0) return;
+    const float* in = input.data.data();
+    float* out = output.data.data();
+
+    // 每组 group 个通道按像素交错：逐像素把整组加到对应输出上，读取保持连续
+    int group = 1;
+    if (input.layout == TensorLayout::CHWc) group = channel_block;
+    else if (input.layout == TensorLayout::HWC) group = channels;
+    for (int b = 0; b < channels / group; b++)
+    {
+        const float* in_b = in + b * plane * group;
+        float* out_b = out + static_cast<size_t>(b) * group;
+        for (size_t p = 0; p < plane; p++)
+        {
+            for (int v = 0; v < group; v++) out_b[v] += in_b[p * group + v];
+        }
+    }
+
+    float scale = 1.0f / static_cast<float>(plane);
+    for (int c = 0; c < channels; c++) out[c] *= scale;
+}
@@ -0,0 +1,39 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef AVGPOOLING_H
+#define AVGPOOLING_H
+
+#include "layer.h"
+#include "Pooling.h"
+#include "Tensor.h"
+
+// 平均池化：窗口参数与 maxPooling 相同，每个输出除以窗口内未越界的抽头个数 (填充不计入)，
+// 因此分块推理时各块的结果与整图一致
+class avgPooling : public layer
+{
+private:
+    pool_params params;
+
+public:
+    avgPooling() = default;
+    explicit avgPooling(const pool_params& m_params) : params(m_params) {}
+    const pool_params& get_params() const { return params; }
+    void forward(const Tensor& input, Tensor& output) override;
+    std::vector<int> get_output_shape(const std::vector<int>& input_shape) const override;
+    bool get_spatial_window(spatial_window& window) const override;
+    void forward_region(const Tensor& input, Tensor& output, int pad_top, int pad_left, int out_h, int out_w) override;
+    ~avgPooling() = default;
+};
+
+// 全局平均池化：[C, H, W] -> [C, 1, 1]，常用来代替 flatten + 大的全连接层。
+// 窗口随输入尺寸变化，不参与分块 / 增量推理；1x1 的输出在各布局下内存排布相同，统一标为 CHW
+class globalAvgPooling : public layer
+{
+public:
+    void forward(const Tensor& input, Tensor& output) override;
+    std::vector<int> get_output_shape(const std::vector<int>& input_shape) const override;
+};
+
+#endif //AVGPOOLING_H
@@ -1,23 +1,10 @@
 // Auto generated data file
 
 
-typedef struct conv_param {
-    int pad;
-    int stride;
-    int kernel_size;
-    int in_channels;
-    int out_channels;
-    float* p_weight;
-    float* p_bias;
-} conv_param;
-
-typedef struct fc_param {
-    int in_features;
-    int out_features;
-    float* p_weight;
-    float* p_bias;
-} fc_param;
+#include "face_binary_cls.h"
 
+namespace face_binary_cls
+{
 
 float conv0_weight[16 * 3 * 3 * 3] = { 0.39464307f, 0.31125212f, -0.113536164f, 0.30107704f, 0.40669382f, 0.42162737f, 0.21860032f, -0.13719831f, -0.2722659f, -0.3841937f, -0.72105736f, -0.58308995f, -0.48366326f, -0.28575644f, -0.05651677f, -0.53083885f, -0.77037054f, -0.7629983f, 0.025733506f, 0.12633972f, -0.17480506f, 0.21570784f, 0.21041252f, -0.100641824f, 0.27207935f, -0.3632402f, -0.25211236f, -0.3779639f, -0.28126734f, -0.099892944f, -0.29411986f, -0.352513f, -0.27488035f, 0.07936121f, -0.11976181f, -0.09621229f, -0.29249555f, -0.35626453f, -0.089926735f, -0.30967128f, -0.45575193f, -0.18596205f, 0.0046898457f, 0.07736333f, 0.11418518f, 0.049611814f, -0.1174234f, -0.061348002f, -0.17694806f, -0.23101062f, -0.01014731f, 0.10893406f, -0.033674054f, 0.055747885f, -0.7857677f, -0.43438435f, -0.23328306f, -0.7045561f, -1.0594592f, -0.96986556f, -0.4306335f, -0.49769416f, -0.38025817f, 0.743165f, 0.39787427f, 0.70530725f, 0.14347716f, 0.31259444f, 0.2433205f, 0.6502008f, 0.17526624f, -0.21967348f, 0.3032335f, 0.6659125f, 0.32520002f, 0.25262007f, 0.21478127f, -0.25885805f, 0.5798695f, 0.10853558f, 0.5885381f, -0.66717565f, -2.0332286f, -2.0057657f, 2.6963172f, 0.49773622f, 1.189053f, 0.8569126f, -0.5478645f, -0.5474117f, -0.38225102f, -0.10105263f, -0.7386174f, 2.0439014f, 1.4866843f, 0.50445044f, -0.5007768f, -1.8825145f, -0.70317525f, -0.8941499f, -0.75519013f, 1.0137452f, -0.21174146f, 1.5843949f, 2.470182f, -2.3377092f, -2.20756f, -0.7657903f, 0.11595148f, -0.029040033f, 0.7682127f, 0.38493067f, 1.1514106f, 1.0909537f, -1.0764828f, -1.1670347f, 0.029069614f, -0.877457f, 0.5579421f, 1.1665275f, -0.18994229f, 0.7673296f, 0.74027365f, -1.4748354f, -1.5412221f, -0.6860829f, -0.18105343f, 0.068953045f, 1.2358037f, -0.5324052f, -0.14725618f, 1.4631968f, -1.3702732f, -0.7870854f, 0.98745936f, 0.26478675f, 0.3556826f, 0.104706556f, 0.25831616f, 0.58448446f, 0.37813473f, 0.0707449f, 0.23480041f, 0.23432183f, -0.0130122695f, 0.1177902f, 0.14724356f, 0.04454773f, 0.30134895f, 0.034679458f, 0.10438265f, 0.080957696f, 0.04673539f, 0.000114658316f, 0.11621634f, -0.061609983f, 0.13820495f, 0.06610005f, 0.024520641f, 0.103318214f, 0.17039937f, -0.07025218f, -0.6798553f, -1.3538299f, -0.82105464f, 2.2388427f, 0.52264774f, -0.36318606f, -1.4912193f, 1.1072139f, 0.33895338f, -1.7142519f, 0.5416925f, -1.0977235f, 1.6462898f, 0.90318096f, 0.94332093f, -1.8965774f, 0.7349083f, -2.4249914f, -1.6165315f, 1.7934322f, 0.48784658f, -0.15854074f, 0.78907776f, 0.014245147f, -2.945607f, 0.5394235f, -0.4857813f, -0.054304346f, -0.3152643f, -0.06946454f, -0.11268508f, -0.17926472f, -0.20574911f, -0.07990353f, -0.49118677f, -0.025087593f, 0.19014266f, -0.18238616f, -0.059863616f, 0.2252154f, -0.17008233f, 0.26245677f, 0.29177034f, -0.2754409f, 0.30317858f, -0.026542168f, -0.56722933f, -0.11456274f, -0.067640044f, -0.10235165f, -0.12649953f, -0.36027682f, -0.49318066f, -0.20856257f, -0.10553966f, 0.14529943f, 0.31293455f, -0.6343524f, -0.41135284f, -0.22918832f, -0.3269688f, -0.4666978f, -0.14151694f, 0.047637857f, 0.3689984f, 0.54759896f, -0.7058803f, -0.5644361f, 0.13388251f, -0.34838295f, -0.7413975f, -0.38709667f, 0.25354767f, -0.007902776f, 0.33674595f, -0.0746156f, -0.27811626f, -0.110156484f, -0.2025166f, -0.2381966f, -0.021202441f, 0.8231694f, -0.6653018f, -1.2321107f, 0.8115323f, -0.122332565f, -1.0530983f, 0.45618296f, 0.102331914f, 0.033566006f, 0.85834605f, -0.29432422f, -1.2657924f, 0.9141286f, -0.3266094f, -0.7053741f, 0.81276864f, 0.07665286f, -0.5127557f, 0.14322002f, -0.7193492f, -0.338985f, 0.97604406f, -0.105564944f, -0.19280234f, 0.526181f, 0.3487025f, -0.12819663f, -0.15909345f, -0.10290787f, -0.5248588f, 0.48928633f, 1.0575275f, 0.14167315f, 0.83029175f, 1.1101023f, 0.5940608f, -0.01074784f, -0.723216f, -0.7768869f, 0.98885226f, 0.54384017f, -0.703233f, 0.63482726f, -0.07262965f, -0.61900723f, 0.4230914f, -0.51311386f, -0.7291202f, 0.27294713f, 0.10586888f, -0.5550978f, 0.22313671f, 0.7238348f, -0.4494153f, 0.29698962f, 0.56095773f, 0.31671995f, 0.17024502f, 0.38235816f, 0.25565818f, -0.1672302f, 0.3076467f, -0.01307815f, 0.14418042f, 0.56610113f, 0.2148333f, 0.15399817f, 0.67229635f, 0.13392828f, 0.20211038f, 0.31115752f, 0.0095776105f, -0.19347395f, 0.015239959f, -0.07266435f, -0.21352863f, -0.048559375f, -0.19423409f, -0.29441926f, -0.21786705f, -0.13871895f, 0.13560575f, -0.2710085f, -0.7794796f, -0.62922764f, -0.96720576f, -1.7171217f, -0.86367893f, -1.268142f, -0.39895812f, 0.55501527f, 0.5426243f, 1.0501138f, 1.3332919f, 1.0797073f, 0.6276182f, 1.3336443f, 0.89330786f, 0.79221326f, -0.031759303f, 0.6283158f, -0.8274064f, -0.26828262f, 0.5890328f, -0.6915631f, 0.29678676f, 0.12777342f, -0.4851606f, -0.21372864f, -0.30243278f, -0.057936516f, -0.22304212f, -0.5086857f, -0.36543858f, 0.061323658f, -0.058094397f, -0.2603215f, -0.04734044f, -0.12903345f, 0.1044603f, -0.17583425f, -0.2569909f, -0.29177812f, 0.011159535f, -0.11316811f, -0.15704016f, -0.112502016f, 0.076443285f, 0.08122089f, -0.00030651398f, -0.19409938f, -0.18510209f, 0.097724915f, -0.13614564f, -0.11792337f, 0.6576927f, -1.0175071f, -0.65340555f, -0.5979028f, 1.1775038f, 0.5222899f, -0.8214336f, 1.736255f, -0.8586219f, -0.79329425f, 0.17091788f, -0.011192297f, -1.8893261f, -0.5987776f, -0.99274975f, -0.58744484f, 1.0230196f, -1.8118623f, 1.0436924f, 0.34172526f, 0.7626623f, 0.16033667f, 0.20234789f, -0.21112663f, -0.40952432f, 2.2407742f, -1.4594872f, -3.1228063f, -3.9376194f, 2.432453f, 1.2279854f, -0.13547976f, -3.1744912f, 1.8420978f, -2.0824459f, 4.346323f, -0.10367142f, -3.9673567f, 2.7665029f, 4.8321104f, 0.17018299f, 0.5056449f, -1.5576425f, -2.362877f, 4.7744937f, 0.57975817f, -2.178875f, 3.423763f, 5.2192326f, 2.6792204f, -4.330439f, -2.3420188f, -6.791226f, 0.863587 };
 float conv0_bias[16] = { 0.5312736f, 2.0255265f, 0.5032426f, 1.0871441f, -0.16811907f, -1.4195297f, 1.3647283f, 1.4160137f, 2.0942433f, 0.37322155f, -0.98419213f, -1.6288463f, 0.11098604f, 1.7342286f, 0.8017651f, 0.11197768 };
@@ -39,3 +26,5 @@ conv_param conv_params[3] = {
 fc_param fc_params[1] = {
     {2048, 2, fc0_weight, fc0_bias}
 };
+
+} // namespace face_binary_cls
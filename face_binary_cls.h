@@ -0,0 +1,33 @@
+//
+// Created on 2026/10/19.
+//
+
+#ifndef FACE_BINARY_CLS_H
+#define FACE_BINARY_CLS_H
+
+// face_binary_cls.cpp (自动生成) 中的另一套人脸分类权重，放在独立的命名空间中，
+// 可以与 main.cpp 中的权重同时链接，由 ModelRegistry 按版本加载
+namespace face_binary_cls
+{
+    typedef struct conv_param {
+        int pad;
+        int stride;
+        int kernel_size;
+        int in_channels;
+        int out_channels;
+        float* p_weight;
+        float* p_bias;
+    } conv_param;
+
+    typedef struct fc_param {
+        int in_features;
+        int out_features;
+        float* p_weight;
+        float* p_bias;
+    } fc_param;
+
+    extern conv_param conv_params[3];
+    extern fc_param fc_params[1];
+}
+
+#endif //FACE_BINARY_CLS_H
@@ -3,6 +3,195 @@
 //
 
 #include "fc_layer.h"
+#include "Conv.h"
+#include "FastMath.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+using namespace std;
+
+namespace
+{
+    constexpr int k_segment = 512;          // K 方向每段的长度：4 行权重与 8 个样本的一段合计 24KB，留在 L1 中
+    constexpr int row_tile = 4;             // 一个任务的输出行数
+    constexpr int batch_tile = 8;           // 一个任务的样本数
+    constexpr double parallel_macs = 1 << 20;   // 乘加数少于此时分线程得不偿失
+
+    // 点积 w · x (长度 n)：第 k 个乘积累加到第 k % 16 路，16 路按固定顺序归约后再加上不足 16 个的尾部。
+    // 下面的几个版本同时计算 1~2 个点积以共享载入的权重 / 输入，但每个点积的累加顺序都与此相同，结果逐位一致
+#ifdef FAST_MATH_SSE2
+    inline float reduce(__m128 a0, __m128 a1, __m128 a2, __m128 a3)
+    {
+        __m128 s = _mm_add_ps(_mm_add_ps(a0, a1), _mm_add_ps(a2, a3));
+        float lanes[4];
+        _mm_storeu_ps(lanes, s);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+#endif
+
+    inline float dot_tail(const float* w, const float* x, int k, int n, float sum)
+    {
+        for (; k < n; k++) sum += w[k] * x[k];
+        return sum;
+    }
+
+    float dot_1x1(const float* w, const float* x, int n)
+    {
+        int k = 0;
+#ifdef FAST_MATH_SSE2
+        __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps(), a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+        for (; k + 16 <= n; k += 16)
+        {
+            a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(w + k), _mm_loadu_ps(x + k)));
+            a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_loadu_ps(w + k + 4), _mm_loadu_ps(x + k + 4)));
+            a2 = _mm_add_ps(a2, _mm_mul_ps(_mm_loadu_ps(w + k + 8), _mm_loadu_ps(x + k + 8)));
+            a3 = _mm_add_ps(a3, _mm_mul_ps(_mm_loadu_ps(w + k + 12), _mm_loadu_ps(x + k + 12)));
+        }
+        float sum = reduce(a0, a1, a2, a3);
+#else
+        float acc[16] = {};
+        for (; k + 16 <= n; k += 16)
+        {
+            for (int l = 0; l < 16; l++) acc[l] += w[k + l] * x[k + l];
+        }
+        float lanes[4];
+        for (int l = 0; l < 4; l++) lanes[l] = (acc[l] + acc[l + 4]) + (acc[l + 8] + acc[l + 12]);
+        float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+        return dot_tail(w, x, k, n, sum);
+    }
+
+    // 两行权重与同一个输入：8 个独立的累加器，输入只载入一次
+    void dot_2x1(const float* w0, const float* w1, const float* x, int n, float& out0, float& out1)
+    {
+#ifdef FAST_MATH_SSE2
+        int k = 0;
+        __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps(), a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+        __m128 b0 = _mm_setzero_ps(), b1 = _mm_setzero_ps(), b2 = _mm_setzero_ps(), b3 = _mm_setzero_ps();
+        for (; k + 16 <= n; k += 16)
+        {
+            __m128 x0 = _mm_loadu_ps(x + k), x1 = _mm_loadu_ps(x + k + 4);
+            __m128 x2 = _mm_loadu_ps(x + k + 8), x3 = _mm_loadu_ps(x + k + 12);
+            a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(w0 + k), x0));
+            b0 = _mm_add_ps(b0, _mm_mul_ps(_mm_loadu_ps(w1 + k), x0));
+            a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_loadu_ps(w0 + k + 4), x1));
+            b1 = _mm_add_ps(b1, _mm_mul_ps(_mm_loadu_ps(w1 + k + 4), x1));
+            a2 = _mm_add_ps(a2, _mm_mul_ps(_mm_loadu_ps(w0 + k + 8), x2));
+            b2 = _mm_add_ps(b2, _mm_mul_ps(_mm_loadu_ps(w1 + k + 8), x2));
+            a3 = _mm_add_ps(a3, _mm_mul_ps(_mm_loadu_ps(w0 + k + 12), x3));
+            b3 = _mm_add_ps(b3, _mm_mul_ps(_mm_loadu_ps(w1 + k + 12), x3));
+        }
+        out0 = dot_tail(w0, x, k, n, reduce(a0, a1, a2, a3));
+        out1 = dot_tail(w1, x, k, n, reduce(b0, b1, b2, b3));
+#else
+        out0 = dot_1x1(w0, x, n);
+        out1 = dot_1x1(w1, x, n);
+#endif
+    }
+
+    // 一行权重与两个输入：权重只载入一次
+    void dot_1x2(const float* w, const float* x0, const float* x1, int n, float& out0, float& out1)
+    {
+#ifdef FAST_MATH_SSE2
+        int k = 0;
+        __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps(), a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+        __m128 b0 = _mm_setzero_ps(), b1 = _mm_setzero_ps(), b2 = _mm_setzero_ps(), b3 = _mm_setzero_ps();
+        for (; k + 16 <= n; k += 16)
+        {
+            __m128 v0 = _mm_loadu_ps(w + k), v1 = _mm_loadu_ps(w + k + 4);
+            __m128 v2 = _mm_loadu_ps(w + k + 8), v3 = _mm_loadu_ps(w + k + 12);
+            a0 = _mm_add_ps(a0, _mm_mul_ps(v0, _mm_loadu_ps(x0 + k)));
+            b0 = _mm_add_ps(b0, _mm_mul_ps(v0, _mm_loadu_ps(x1 + k)));
+            a1 = _mm_add_ps(a1, _mm_mul_ps(v1, _mm_loadu_ps(x0 + k + 4)));
+            b1 = _mm_add_ps(b1, _mm_mul_ps(v1, _mm_loadu_ps(x1 + k + 4)));
+            a2 = _mm_add_ps(a2, _mm_mul_ps(v2, _mm_loadu_ps(x0 + k + 8)));
+            b2 = _mm_add_ps(b2, _mm_mul_ps(v2, _mm_loadu_ps(x1 + k + 8)));
+            a3 = _mm_add_ps(a3, _mm_mul_ps(v3, _mm_loadu_ps(x0 + k + 12)));
+            b3 = _mm_add_ps(b3, _mm_mul_ps(v3, _mm_loadu_ps(x1 + k + 12)));
+        }
+        out0 = dot_tail(w, x0, k, n, reduce(a0, a1, a2, a3));
+        out1 = dot_tail(w, x1, k, n, reduce(b0, b1, b2, b3));
+#else
+        out0 = dot_1x1(w, x0, n);
+        out1 = dot_1x1(w, x1, n);
+#endif
+    }
+
+    // 一个任务：样本 [n0, n1) x 输出 [o0, o1) 在 K 段 [k0, k0 + len) 上的部分和，写入 partial[n][o]
+    void fc_tile(const float* weights, const float* input, float* partial, int in_features, int out_features,
+                 int n0, int n1, int o0, int o1, int k0, int len)
+    {
+        if (n1 - n0 == 1)
+        {
+            // GEMV：两行权重同时计算，输入段只读一次
+            const float* x = input + static_cast<size_t>(n0) * in_features + k0;
+            float* dst = partial + static_cast<size_t>(n0) * out_features;
+            int o = o0;
+            for (; o + 2 <= o1; o += 2)
+            {
+                dot_2x1(weights + static_cast<size_t>(o) * in_features + k0, weights + static_cast<size_t>(o + 1) * in_features + k0,
+                        x, len, dst[o], dst[o + 1]);
+            }
+            if (o < o1) dst[o] = dot_1x1(weights + static_cast<size_t>(o) * in_features + k0, x, len);
+            return;
+        }
+
+        // GEMM：一行权重同时与两个样本相乘，这一段权重在整个样本块上重复使用
+        for (int o = o0; o < o1; o++)
+        {
+            const float* w = weights + static_cast<size_t>(o) * in_features + k0;
+            int n = n0;
+            for (; n + 2 <= n1; n += 2)
+            {
+                dot_1x2(w, input + static_cast<size_t>(n) * in_features + k0, input + static_cast<size_t>(n + 1) * in_features + k0,
+                        len, partial[static_cast<size_t>(n) * out_features + o], partial[static_cast<size_t>(n + 1) * out_features + o]);
+            }
+            if (n < n1)
+            {
+                partial[static_cast<size_t>(n) * out_features + o] = dot_1x1(w, input + static_cast<size_t>(n) * in_features + k0, len);
+            }
+        }
+    }
+
+    // 执行 count 个相互独立的任务：调用线程与 pool 中的线程以原子计数领取任务，调用线程只等待已被领取的任务。
+    // pool 忙 (或调用线程本身就在 pool 中) 时调用线程独自做完全部任务，迟到的辅助线程领不到任务直接返回
+    void run_tasks(ThreadPool* pool, int count, const function<void(int)>& task)
+    {
+        if (!pool || pool->size() <= 1 || count <= 1)
+        {
+            for (int t = 0; t < count; t++) task(t);
+            return;
+        }
+
+        struct task_state
+        {
+            atomic<int> next{0};
+            int done = 0;
+            mutex mtx;
+            condition_variable cv;
+        };
+        auto state = make_shared<task_state>();
+        auto drain = [state, &task, count] {
+            int finished = 0;
+            for (int t; (t = state->next.fetch_add(1)) < count; finished++) task(t);
+            if (finished == 0) return;
+            lock_guard<mutex> lock(state->mtx);
+            state->done += finished;
+            if (state->done == count) state->cv.notify_all();
+        };
+
+        int helpers = static_cast<int>(min(pool->size(), static_cast<size_t>(count - 1)));
+        for (int i = 0; i < helpers; i++) pool->submit(drain);
+        drain();
+
+        unique_lock<mutex> lock(state->mtx);
+        state->cv.wait(lock, [&] { return state->done == count; });
+    }
+}
 
 fc_layer::fc_layer(const float* weights_data, int in_features, int out_features, const float* biases_data, int bias_size)
 {
@@ -45,50 +234,114 @@ fc_layer::fc_layer(const float* weights_data, int in_features, int out_features,
     }
 }
 
+std::shared_ptr<Conv> fc_layer::to_conv(int in_channels, int kernel_size) const
+{
+    int out_features = this->weights.shape[0];
+    int in_features = this->weights.shape[1];
+    if (in_channels * kernel_size * kernel_size != in_features)
+    {
+        throw std::invalid_argument("fc_layer: in_channels * kernel_size^2 must equal in_features");
+    }
+
+    auto conv = std::make_shared<Conv>(0, 1, kernel_size, in_channels, out_features, this->weights.data.data(),
+                                       this->biases.data.data(), out_features);
+    conv->set_activation(epilogue);
+    return conv;
+}
+
+void fc_layer::prepare_channels_last(int channels)
+{
+    int out_features = this->weights.shape[0];
+    int in_features = this->weights.shape[1];
+    if (channels <= 0 || in_features % channels != 0)
+    {
+        throw std::invalid_argument("fc_layer: in_features must be a multiple of the channel count");
+    }
+
+    int plane = in_features / channels;
+    hwc_weights.shape = this->weights.shape;
+    hwc_weights.data.resize(this->weights.data.size());
+    for (int o = 0; o < out_features; o++)
+    {
+        const float* src = this->weights.data.data() + static_cast<size_t>(o) * in_features;
+        float* dst = hwc_weights.data.data() + static_cast<size_t>(o) * in_features;
+        for (int c = 0; c < channels; c++)
+        {
+            for (int p = 0; p < plane; p++) dst[p * channels + c] = src[c * plane + p];
+        }
+    }
+}
+
 std::vector<int> fc_layer::get_output_shape(const std::vector<int>& input_shape) const
 {
-    if (input_shape.size() != 1)
+    if (input_shape.size() != 1 && input_shape.size() != 2)
     {
-        throw std::invalid_argument("fc_layer: input shape must be 1-dimensional");
+        throw std::invalid_argument("fc_layer: input shape must be [in_features] or [batch, in_features]");
     }
 
     int in_features = this->weights.shape[1];
-    if (input_shape[0] != in_features)
+    if (input_shape.back() != in_features)
     {
         throw std::invalid_argument("fc_layer: input shape must have the same number of elements");
     }
 
     int out_features = this->weights.shape[0];
-
+    if (input_shape.size() == 2)
+    {
+        return {input_shape[0], out_features};
+    }
     return {out_features};
 }
 
 void fc_layer::forward(const Tensor &input, Tensor &output)
 {
-    if (input.shape.size() != 1)
-    {
-        throw std::invalid_argument("fc_layer: input shape must be 1-dimensional");
-    }
+    output.shape = get_output_shape(input.shape);
 
     int out_features = this->weights.shape[0];
     int in_features = this->weights.shape[1];
-    if (input.shape[0] != in_features)
+    int batch = input.shape.size() == 2 ? input.shape[0] : 1;
+
+    const Tensor* w = &this->weights;
+    if (input.layout == TensorLayout::HWC)
     {
-        throw std::invalid_argument("fc_layer: input shape must have the same number of elements");
+        if (hwc_weights.data.empty())
+        {
+            throw std::invalid_argument("fc_layer: HWC input requires prepare_channels_last");
+        }
+        w = &hwc_weights;
     }
 
-    output.shape = {out_features};
     output.data.resize(output.size());
+    output.layout = TensorLayout::CHW;
+    if (batch == 0) return;
 
-    for (int o = 0; o < out_features; o++)
+    // 任务按 (输出块, K 段, 样本块) 编号，样本块变化最快：单线程时同一块权重连续用于所有样本块
+    int segments = (in_features + k_segment - 1) / k_segment;
+    int row_blocks = (out_features + row_tile - 1) / row_tile;
+    int batch_blocks = (batch + batch_tile - 1) / batch_tile;
+    vector<float> partial(static_cast<size_t>(segments) * batch * out_features);
+
+    const float* w_data = w->data.data();
+    const float* x_data = input.data.data();
+    size_t partial_stride = static_cast<size_t>(batch) * out_features;
+    auto task = [&](int t) {
+        int nb = t % batch_blocks;
+        int s = t / batch_blocks % segments;
+        int ob = t / batch_blocks / segments;
+        int k0 = s * k_segment;
+        fc_tile(w_data, x_data, partial.data() + s * partial_stride, in_features, out_features,
+                nb * batch_tile, min(batch, (nb + 1) * batch_tile), ob * row_tile, min(out_features, (ob + 1) * row_tile),
+                k0, min(k_segment, in_features - k0));
+    };
+
+    double macs = static_cast<double>(batch) * out_features * in_features;
+    run_tasks(macs >= parallel_macs ? pool : nullptr, row_blocks * segments * batch_blocks, task);
+
+    // 各段的部分和按段的顺序相加，再加偏置并执行融合的激活
+    for (size_t i = 0; i < partial_stride; i++)
     {
-        float sum = 0.0f;
-        for (int i = 0; i < in_features; i++)
-        {
-            sum += input.data[i] * this->weights({o, i});
-        }
-        float final_output_value = sum + biases({o});
-        output({o}) = final_output_value;
+        float sum = partial[i];
+        for (int s = 1; s < segments; s++) sum += partial[s * partial_stride + i];
+        output.data[i] = epilogue(sum + biases.data[i % out_features]);
     }
 }
-
@@ -7,16 +7,43 @@
 
 #include "layer.h"
 #include "Tensor.h"
+#include "Activation.h"
+#include <memory>
 
+class Conv;
+class ThreadPool;
+
+// 全连接层。输入 [in] 时为 GEMV，输入 [N, in] (N 个样本按行堆叠) 时为分块 GEMM：
+// 一块权重 (若干输出行 x K 方向的一段) 载入缓存后依次与一块样本相乘，权重从内存只读一遍，
+// 批量越大，每个样本分摊的权重读取越少。每个点积用 16 路独立累加器 (SSE2 下为 4 个向量寄存器) 打破加法的依赖链，
+// K 方向固定分段求和后按段的顺序相加，因此结果与批大小、线程数无关 (同一样本单独推理与成批推理逐位一致)
 class fc_layer : public layer
 {
 private:
     Tensor weights;
     Tensor biases;
+    Tensor hwc_weights;   // 按 [H][W][C] 展平顺序重排的权重，输入标记为 HWC 时使用；未准备时为空
+    Activation epilogue;  // 加上偏置后、写回前执行的激活
+    ThreadPool* pool = nullptr;   // 非空且乘加数足够多时按输出块、K 段与样本块分线程计算
 public:
     fc_layer(const float* weights_data,  int in_features, int out_features, const float* biases_data, int bias_size);
     void forward(const Tensor &input, Tensor &output) override;
+
+    // 调用线程也参与计算，只等待已开始执行的任务，因此 pool 可以是调用方自己所在的线程池
+    void set_thread_pool(ThreadPool* m_pool) { pool = m_pool; }
+    ThreadPool* get_thread_pool() const { return pool; }
     std::vector<int> get_output_shape(const std::vector<int>& input_shape) const override;
+
+    // 融合的激活，默认不做变换
+    void set_activation(const Activation& activation) { epilogue = activation; }
+    const Activation& get_activation() const { return epilogue; }
+
+    // 输入来自 channels 个通道的 HWC 特征图时，一次性把权重的列从 CHW 展平顺序重排为 HWC 展平顺序
+    void prepare_channels_last(int channels);
+
+    // 把全连接层改写为等价的卷积层：输入按 CHW 展平，因此权重 {out, C*K*K} 可直接视为 {out, C, K, K}。
+    // 在更大的特征图上滑动该卷积，即得到每个窗口位置的全连接输出 (融合的激活一并带上)
+    std::shared_ptr<Conv> to_conv(int in_channels, int kernel_size) const;
     ~fc_layer() = default;
 };
 
@@ -3,6 +3,7 @@
 //
 
 #include "flatten.h"
+#include "Layout.h"
 
 using namespace std;
 
@@ -18,6 +19,15 @@ vector<int> flattenLayer::get_output_shape(const vector<int>& input_shape)const
 
 void flattenLayer::forward(const Tensor& input, Tensor& output)
 {
+    // CHWc 在这里 (图的边界) 还原为 CHW 顺序；HWC 直接按 [H][W][C] 展平并保留标记，
+    // 由全连接层换用重排过的权重
     output.shape = {input.size()};
-    output.data = input.data;
-}
\ No newline at end of file
+    output.data = input.layout == TensorLayout::CHWc ? to_planar(input).data : input.data;
+    output.layout = input.layout == TensorLayout::HWC ? TensorLayout::HWC : TensorLayout::CHW;
+}
+void flattenLayer::forward_inplace(Tensor& tensor)
+{
+    if (tensor.layout == TensorLayout::CHWc) tensor = to_planar(tensor);
+    tensor.shape = {tensor.size()};
+    if (tensor.layout != TensorLayout::HWC) tensor.layout = TensorLayout::CHW;
+}
@@ -16,6 +16,9 @@ public:
     flattenLayer() = default;
     vector<int> get_output_shape(const vector<int>& input_shape) const override;
     void forward(const Tensor& input, Tensor& output) override;
+    // 只改形状；CHWc 输入仍需还原一次排布
+    bool supports_inplace() const override { return true; }
+    void forward_inplace(Tensor& tensor) override;
     ~flattenLayer() = default;
 };
 
@@ -8,6 +8,14 @@
 #include <vector>
 #include "Tensor.h"
 
+// 在空间上滑窗计算的层 (卷积、池化以及逐元素层) 的几何参数，用于推算感受野与输出位置
+struct spatial_window
+{
+    int kernel_h = 1, kernel_w = 1;
+    int stride_h = 1, stride_w = 1;
+    int pad_h = 0, pad_w = 0;
+};
+
 class layer
 {
 public:
@@ -15,7 +23,41 @@ public:
 
     virtual std::vector<int> get_output_shape(const std::vector<int>& input_shape)const = 0;
 
+    // 空间层填写 window 并返回 true；flatten、全连接、softmax 等非空间层返回 false
+    virtual bool get_spatial_window(spatial_window&) const { return false; }
+
+    // 分块推理用：以显式的上/左填充计算 out_h x out_w 个输出，窗口超出 input 的部分按填充处理
+    // (右/下方的填充由 out_h、out_w 隐含)。默认实现适用于逐元素层，输出与输入同尺寸
+    virtual void forward_region(const Tensor& input, Tensor& output, int, int, int, int)
+    {
+        forward(input, output);
+    }
+
+    // 逐元素层、reshape 一类的层可以直接改写输入张量，省去一份同样大小的输出及其读写
+    virtual bool supports_inplace() const { return false; }
+
+    // 原地执行：结果写回 tensor。默认实现经由临时输出，只有 supports_inplace() 为 true 的层才真正原地计算
+    virtual void forward_inplace(Tensor& tensor)
+    {
+        Tensor output;
+        forward(tensor, output);
+        tensor = std::move(output);
+    }
+
     virtual ~layer()  = default;
 };
 
+// 执行一层，使 current 变为该层的输出：支持原地执行的层直接改写 current，其余层写入新张量后移动过来
+inline void run_layer(layer& m_layer, Tensor& current)
+{
+    if (m_layer.supports_inplace())
+    {
+        m_layer.forward_inplace(current);
+        return;
+    }
+    Tensor next;
+    m_layer.forward(current, next);
+    current = std::move(next);
+}
+
 #endif //LAYER_H
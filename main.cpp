@@ -2,6 +2,23 @@
 // Created by  on 2025/5/21
 //
 #include "CNN.h"
+#include "BulkScorer.h"
+#include "Benchmark.h"
+#include "Detector.h"
+#include "Preprocess.h"
+#include "TensorCache.h"
+#include "TiledInference.h"
+#include "VideoSession.h"
+#include "VideoStream.h"
+#include "ShmInference.h"
+#include "ModelRegistry.h"
+#include "face_binary_cls.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <thread>
 
 typedef struct conv_param {
     int pad;
@@ -42,21 +59,354 @@ fc_param fc_params[1] = {
     {2048, 2, fc0_weight, fc0_bias}
 };
 
-int main()
+// 磬ļ face_binary_cls.cpp еȨع
+template <typename ConvParam, typename FcParam>
+shared_ptr<CNN> build_face_cnn(const ConvParam* conv_params, const FcParam* fc_params)
 {
-    CNN cnn;
-
-    cnn.add_layer(make_shared<Conv>(conv_params[0].pad, conv_params[0].stride, conv_params[0].kernel_size, conv_params[0].in_channels, conv_params[0].out_channels, conv_params[0].p_weight, conv_params[0].p_bias, 16));
-    cnn.add_layer(make_shared<reluLayer>());
-    cnn.add_layer(make_shared<maxPooling>(2, 2, 2, 2));
-    cnn.add_layer(make_shared<Conv>(conv_params[1].pad, conv_params[1].stride, conv_params[1].kernel_size, conv_params[1].in_channels, conv_params[1].out_channels, conv_params[1].p_weight, conv_params[1].p_bias, 32));
-    cnn.add_layer(make_shared<reluLayer>());
-    cnn.add_layer(make_shared<maxPooling>(2, 2, 2, 2));
-    cnn.add_layer(make_shared<Conv>(conv_params[2].pad, conv_params[2].stride, conv_params[2].kernel_size, conv_params[2].in_channels, conv_params[2].out_channels, conv_params[2].p_weight, conv_params[2].p_bias, 32));
-    cnn.add_layer(make_shared<reluLayer>());
-    cnn.add_layer(make_shared<flattenLayer>());
-    cnn.add_layer(make_shared<fc_layer>(fc_params[0].p_weight, fc_params[0].in_features, fc_params[0].out_features, fc_params[0].p_bias, 2));
-    cnn.add_layer(make_shared<softMax>());
+    auto cnn = make_shared<CNN>();
+
+    cnn->add_layer(make_shared<Conv>(conv_params[0].pad, conv_params[0].stride, conv_params[0].kernel_size, conv_params[0].in_channels, conv_params[0].out_channels, conv_params[0].p_weight, conv_params[0].p_bias, 16));
+    cnn->add_layer(make_shared<reluLayer>());
+    cnn->add_layer(make_shared<maxPooling>(2, 2, 2, 2));
+    cnn->add_layer(make_shared<Conv>(conv_params[1].pad, conv_params[1].stride, conv_params[1].kernel_size, conv_params[1].in_channels, conv_params[1].out_channels, conv_params[1].p_weight, conv_params[1].p_bias, 32));
+    cnn->add_layer(make_shared<reluLayer>());
+    cnn->add_layer(make_shared<maxPooling>(2, 2, 2, 2));
+    cnn->add_layer(make_shared<Conv>(conv_params[2].pad, conv_params[2].stride, conv_params[2].kernel_size, conv_params[2].in_channels, conv_params[2].out_channels, conv_params[2].p_weight, conv_params[2].p_bias, 32));
+    cnn->add_layer(make_shared<reluLayer>());
+    cnn->add_layer(make_shared<flattenLayer>());
+    cnn->add_layer(make_shared<fc_layer>(fc_params[0].p_weight, fc_params[0].in_features, fc_params[0].out_features, fc_params[0].p_bias, 2));
+    cnn->add_layer(make_shared<softMax>());
+    // мͼʹֿͨ鲼֣ CHW λһ (bench layout Ա)
+    cnn->set_layout(TensorLayout::CHWc);
+    return cnn;
+}
+
+int main(int argc, char** argv)
+{
+    // 汾 1 ΪļеȨأ汾 2 Ϊ face_binary_cls.cpp еȨ
+    ModelRegistry registry;
+    registry.register_model("face", 1, [] { return build_face_cnn(conv_params, fc_params); });
+    registry.register_model("face", 2, [] { return build_face_cnn(face_binary_cls::conv_params, face_binary_cls::fc_params); });
+    registry.publish("face", 1);
+
+    ServedModel& served = registry.served("face");
+
+    // лʾ: OOPVS swap-test <ͼ> [л]̳߳ͬʱ汾л
+    if (argc >= 3 && string(argv[1]) == "swap-test")
+    {
+        int swaps = argc >= 4 ? atoi(argv[3]) : 10;
+        // ֻ served ģͣڳκΰ汾滻İ汾;󼴿ͷ
+        Tensor input = served.get()->cnn->load_image_as_tensor(argv[2]);
+        atomic<bool> stop{false};
+        atomic<long long> served_requests{0}, failed_requests{0};
+
+        vector<thread> clients;
+        for (int t = 0; t < 2; t++)
+        {
+            clients.emplace_back([&, input]() mutable {
+                while (!stop)
+                {
+                    try
+                    {
+                        served.predict(input);
+                        served_requests++;
+                    }
+                    catch (const exception&)
+                    {
+                        failed_requests++;
+                    }
+                }
+            });
+        }
+        for (int i = 0; i < swaps; i++)
+        {
+            registry.publish("face", i % 2 == 0 ? 2 : 1);
+            cout << "published face v" << served.get()->version << ", versions still draining: " << served.draining() << endl;
+        }
+        stop = true;
+        for (auto& client : clients) client.join();
+        cout << served_requests << " requests served, " << failed_requests << " failed, draining after stop: "
+             << served.draining() << endl;
+        return 0;
+    }
+
+    // ģʽʱȡһ v1 ڼֱʹãע
+    shared_ptr<const LoadedModel> model = served.get();
+    CNN& cnn = *model->cnn;
+
+    // : OOPVS score <Ŀ¼|бļ> <.csv|.bin> [I/O߳] [С] []
+    if (argc >= 4 && string(argv[1]) == "score")
+    {
+        BulkScoreConfig config;
+        if (argc >= 5) config.io_threads = atoi(argv[4]);
+        if (argc >= 6) config.batch_size = atoi(argv[5]);
+        if (argc >= 7) config.cache_capacity = static_cast<size_t>(atoll(argv[6]));
+
+        string out_path = argv[3];
+        bool binary = out_path.size() >= 4 && out_path.compare(out_path.size() - 4, 4, ".bin") == 0;
+        config.format = binary ? ScoreOutputFormat::Binary : ScoreOutputFormat::CSV;
+        ofstream out(out_path, binary ? ios::binary : ios::out);
+
+        BulkScorer scorer(cnn, config);
+        BulkScoreStats stats = scorer.run(BulkScorer::collect_paths(argv[2]), out);
+        stats.print(cout);
+        return 0;
+    }
+
+    // Ԥ: OOPVS cache <Ŀ¼|бļ> <.tcache> [f32|f16|u8]
+    if (argc >= 4 && string(argv[1]) == "cache")
+    {
+        string type = argc >= 5 ? argv[4] : "f32";
+        PixelType dtype = type == "u8" ? PixelType::U8 : (type == "f16" ? PixelType::F16 : PixelType::F32);
+
+        TensorCacheWriter writer(argv[3], dtype, 3, 128, 128);
+        Tensor tensor;
+        for (const string& path : BulkScorer::collect_paths(argv[2]))
+        {
+            try
+            {
+                image_to_tensor(read_image(path, 128, 128), 128, 128, tensor);
+                writer.add(path, tensor);
+            }
+            catch (const exception& e)
+            {
+                cerr << e.what() << endl;
+            }
+        }
+        writer.finish();
+        cout << "cached " << writer.size() << " tensors to " << argv[3] << endl;
+        return 0;
+    }
+
+    // ܼ: OOPVS detect <ͼ> [ͼ.png]
+    if (argc >= 3 && string(argv[1]) == "detect")
+    {
+        FaceDetector detector(cnn);
+        Tensor image = cnn.load_image_as_tensor(argv[2]);
+        Tensor heat = detector.heatmap(image);
+
+        int rows = heat.shape[0], cols = heat.shape[1];
+        int best = static_cast<int>(max_element(heat.data.begin(), heat.data.end()) - heat.data.begin());
+        int by = best / cols * detector.get_stride_h(), bx = best % cols * detector.get_stride_w();
+        cout << "heatmap " << rows << "x" << cols << ", best p_face " << heat.data[best] << " at window ("
+             << bx << ", " << by << ", " << detector.get_window_w() << "x" << detector.get_window_h() << ")" << endl;
+
+        if (argc >= 4)
+        {
+            cv::Mat visual(rows, cols, CV_32F, heat.data.data());
+            cv::Mat gray;
+            visual.convertTo(gray, CV_8U, 255.0);
+            cv::imwrite(argv[3], gray);
+        }
+        return 0;
+    }
+
+    // ߶ȼ: OOPVS pyramid <ͼ> [ע.jpg]
+    if (argc >= 3 && string(argv[1]) == "pyramid")
+    {
+        FaceDetector detector(cnn);
+        PyramidDetector pyramid(detector, PyramidConfig());
+        cv::Mat image = read_image(argv[2]);
+
+        PyramidStats stats;
+        vector<Detection> boxes = pyramid.detect(image, &stats);
+        stats.print(cout);
+        for (const Detection& box : boxes)
+        {
+            cout << "face " << box.score << " at (" << box.x << ", " << box.y << ", " << box.width << "x" << box.height << ")" << endl;
+            cv::rectangle(image, cv::Rect2f(box.x, box.y, box.width, box.height), cv::Scalar(0, 255, 0), 2);
+        }
+        if (argc >= 4) cv::imwrite(argv[3], image);
+        return 0;
+    }
+
+    // ͼֿ: OOPVS tiled <ͼ> [ֿ߳]
+    if (argc >= 3 && string(argv[1]) == "tiled")
+    {
+        int tile = argc >= 4 ? stoi(argv[3]) : 16;
+        TiledRunner runner(cnn, tile, tile);
+        cv::Mat image = read_image(argv[2]);
+
+        // ֱ cv::Mat  HWC 8 λϽͼͼ Tensor
+        ImageView view(image.data, PixelType::U8, PixelLayout::HWC, image.channels(), image.rows, image.cols);
+        view.stride_h = static_cast<ptrdiff_t>(image.step);
+
+        // ܸͨ󼤻ͼ
+        vector<int> shape = runner.output_shape(view);
+        vector<float> channel_max(shape[0], -numeric_limits<float>::infinity());
+        TiledStats stats;
+        runner.run(view, [&channel_max](const Tensor& tile, int, int) {
+            size_t plane = static_cast<size_t>(tile.shape[1]) * tile.shape[2];
+            for (size_t c = 0; c < channel_max.size(); c++)
+            {
+                const float* src = tile.data.data() + c * plane;
+                channel_max[c] = max(channel_max[c], *max_element(src, src + plane));
+            }
+        }, &stats);
+        cout << "tiled " << runner.prefix_size() << " layers: output " << shape[0] << "x" << shape[1]
+             << "x" << shape[2] << ", max activation " << *max_element(channel_max.begin(), channel_max.end())
+             << ", " << stats.tiles << " tiles, peak tile tensor "
+             << stats.peak_tile_floats * sizeof(float) / 1024.0 << " KiB, halo overhead " << stats.halo_overhead * 100.0
+             << "%" << endl;
+        return 0;
+    }
+
+    // Ƶ: OOPVS incremental <Ƶļ> [ֵ]
+    if (argc >= 3 && string(argv[1]) == "incremental")
+    {
+        VideoSessionConfig config;
+        if (argc >= 4) config.tolerance = stof(argv[3]);
+        VideoSession session(cnn, config);
+
+        cv::VideoCapture capture(argv[2]);
+        if (!capture.isOpened())
+        {
+            throw runtime_error("Could not open video: " + string(argv[2]));
+        }
+
+        cv::Mat frame;
+        Tensor input;
+        int frames = 0;
+        double skipped_sum = 0.0, ms_sum = 0.0;
+        while (capture.read(frame))
+        {
+            image_to_tensor(frame, 128, 128, input);
+            VideoFrameStats stats;
+            Tensor output = session.process(input, &stats);
+            cout << "frame " << frames << " p_face " << output.data[0] << ", ";
+            stats.print(cout);
+            skipped_sum += stats.skipped_fraction;
+            ms_sum += stats.ms;
+            frames++;
+        }
+        if (frames > 0)
+        {
+            cout << frames << " frames, average skipped " << skipped_sum / frames * 100.0 << "% of work, "
+                 << ms_sum / frames << " ms/frame" << endl;
+        }
+        return 0;
+    }
+
+    // Ƶ: OOPVS video <Ƶļ|ͷ> [block|drop-oldest|drop-newest]
+    if (argc >= 3 && string(argv[1]) == "video")
+    {
+        VideoStreamConfig config;
+        string policy = argc >= 4 ? argv[3] : "block";
+        if (policy == "drop-oldest") config.policy = FrameDropPolicy::DropOldest;
+        else if (policy == "drop-newest") config.policy = FrameDropPolicy::DropNewest;
+        else if (policy != "block") throw invalid_argument("Unknown frame drop policy: " + policy);
+
+        VideoStream stream(cnn, config);
+        VideoStreamStats stats = stream.run(argv[2], [](const VideoFrameResult& result) {
+            cout << "frame " << result.index << ": p_face " << result.p_face << ", latency " << result.latency_ms << " ms" << endl;
+        });
+        stats.print(cout);
+        return 0;
+    }
+
+    // ڴ: OOPVS shm-serve <>һֱֱ̱
+    if (argc >= 3 && string(argv[1]) == "shm-serve")
+    {
+        ShmInferenceServer server(cnn, argv[2]);
+        atomic<bool> stop{false};
+        server.serve(stop);
+        return 0;
+    }
+
+    // ڴͻ: OOPVS shm-client <> <Ŀ¼|б.txt> [ͻ˱]
+    if (argc >= 4 && string(argv[1]) == "shm-client")
+    {
+        vector<string> paths = BulkScorer::collect_paths(argv[3]);
+        ShmInferenceClient client(argv[2], argc >= 5 ? static_cast<uint32_t>(stoul(argv[4])) : 1);
+
+        // ڱɽԤ (ͼ׳)д룬Ĳܻᱻύ
+        size_t received = 0;
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            Tensor input = cnn.load_image_as_tensor(paths[i].c_str());
+            if (input.layout != TensorLayout::CHW) input = to_planar(input);
+
+            uint64_t ticket = 0;
+            float* slot = client.begin_request(ticket, 3, 128, 128);
+            if (!slot)
+            {
+                cerr << "server not responding" << endl;
+                return 1;
+            }
+            copy(input.data.begin(), input.data.end(), slot);
+            client.submit(ticket, i);
+
+            uint64_t id = 0;
+            vector<float> result;
+            while (received <= i && client.receive(id, result, 0))
+            {
+                cout << paths[id] << ',' << result[0] << ',' << result[1] << '\n';
+                received++;
+            }
+        }
+        uint64_t id = 0;
+        vector<float> result;
+        while (received < paths.size() && client.receive(id, result, 5000))
+        {
+            cout << paths[id] << ',' << result[0] << ',' << result[1] << '\n';
+            received++;
+        }
+        cout.flush();
+        return received == paths.size() ? 0 : 1;
+    }
+
+    // ׼: OOPVS bench <Ŀ> [...]
+    if (argc >= 3 && string(argv[1]) == "bench")
+    {
+        string name = argv[2];
+        if (name == "decode" && argc >= 4)
+        {
+            bench_decode(BulkScorer::collect_paths(argv[3]), 128, 128, cout);
+            return 0;
+        }
+        if (name == "filecache" && argc >= 4)
+        {
+            bench_file_cache(cnn, BulkScorer::collect_paths(argv[3]), argc >= 5 ? atoi(argv[4]) : 5, cout);
+            return 0;
+        }
+        if (name == "cache" && argc >= 4)
+        {
+            TensorCacheReader cache(argv[3]);
+            bench_cache(cnn, cache, argc >= 5 ? atoi(argv[4]) : 10, cout);
+            return 0;
+        }
+        if (name == "topk" && argc >= 4)
+        {
+            TensorCacheReader cache(argv[3]);
+            bench_topk(cnn, cache, argc >= 5 ? atoi(argv[4]) : 100, cout);
+            return 0;
+        }
+        if (name == "layout" && argc >= 4)
+        {
+            TensorCacheReader cache(argv[3]);
+            bench_layout(cnn, cache, argc >= 5 ? atoi(argv[4]) : 3, cout);
+            return 0;
+        }
+        if (name == "pipeline" && argc >= 4)
+        {
+            TensorCacheReader cache(argv[3]);
+            bench_pipeline(cnn, cache, argc >= 5 ? atoi(argv[4]) : 0, cout);
+            return 0;
+        }
+        if (name == "coro" && argc >= 4)
+        {
+            bench_coroutines(cnn, BulkScorer::collect_paths(argv[3]), argc >= 5 ? atoi(argv[4]) : 1000, cout);
+            return 0;
+        }
+        if (name == "fc")
+        {
+            bench_fc(argc >= 4 ? atoi(argv[3]) : 2048, argc >= 5 ? atoi(argv[4]) : 2, argc >= 6 ? atoi(argv[5]) : 32,
+                     argc >= 7 ? atoi(argv[6]) : 200, cout);
+            return 0;
+        }
+        cerr << "unknown benchmark: " << name << endl;
+        return 1;
+    }
 
     Tensor input1 = cnn.load_image_as_tensor("man.jpg");
     Tensor output1 = cnn.predict(input1);
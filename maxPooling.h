@@ -6,19 +6,31 @@
 #define MAXPOOLING_H
 
 #include "layer.h"
+#include "Pooling.h"
 #include "Tensor.h"
 
+// 最大池化，支持填充、空洞 (dilation) 与 ceil_mode；越界的抽头不参与取最大值，输出保持输入布局。
+// 2x2 / 步长 2 的常见情形在内部区域走向量化的快速路径 (见 Pooling.h)
 class maxPooling : public layer
 {
 private:
-    int pool_h, pool_w;
-    int stride_h, stride_w;
+    pool_params params;
 
 public:
     maxPooling() = default;
-    maxPooling(int h, int w, int stride_h, int stride_w) : pool_h(h), pool_w(w), stride_h(stride_h), stride_w(stride_w) {}
+    maxPooling(int h, int w, int stride_h, int stride_w)
+    {
+        params.kernel_h = h;
+        params.kernel_w = w;
+        params.stride_h = stride_h;
+        params.stride_w = stride_w;
+    }
+    explicit maxPooling(const pool_params& m_params) : params(m_params) {}
+    const pool_params& get_params() const { return params; }
     void forward(const Tensor &input, Tensor &output) override;
     std::vector<int> get_output_shape(const std::vector<int>& input_shape) const override;
+    bool get_spatial_window(spatial_window& window) const override;
+    void forward_region(const Tensor& input, Tensor& output, int pad_top, int pad_left, int out_h, int out_w) override;
     ~maxPooling() = default;
 };
 
@@ -3,10 +3,147 @@
 //
 
 #include "softMax.h"
+#include "FastMath.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <stdexcept>
 
 using namespace std;
 
+namespace
+{
+    // e^(a - b)，其中 b >= a 为当前的最大值；a 为 -inf 时返回 0 (b 也为 -inf 时 a - b 是 NaN)
+    inline float exp_diff(float a, float b)
+    {
+        return a == -numeric_limits<float>::infinity() ? 0.0f : fast_math::exp(a - b);
+    }
+
+    // 在线更新：x 大于当前最大值时先把已有的和缩放到新的最大值下，只在最大值变化时多算一次 exp
+    inline void online_update(float x, float& max_val, float& total)
+    {
+        if (x > max_val)
+        {
+            total = total * exp_diff(max_val, x) + 1.0f;
+            max_val = x;
+        }
+        else
+        {
+            total += exp_diff(x, max_val);
+        }
+    }
+
+#ifdef FAST_MATH_SSE2
+    inline __m128 exp_diff4(__m128 a, __m128 b)
+    {
+        __m128 masked = _mm_cmpeq_ps(a, _mm_set1_ps(-numeric_limits<float>::infinity()));
+        return _mm_andnot_ps(masked, fast_math::exp4(_mm_sub_ps(a, b)));
+    }
+#endif
+
+    // 第二遍：写出 softmax 或 log-softmax
+    inline float finish(float x, float max_val, float inv_total, float log_total, bool log)
+    {
+        return log ? x - max_val - log_total : fast_math::exp(x - max_val) * inv_total;
+    }
+
+    // 连续的一行 (softmax 的维度是最后一维)：4 个通道各自维护最大值与和，最后再合并
+    void softmax_row(const float* in, float* out, int n, bool log)
+    {
+        float max_val = -numeric_limits<float>::infinity();
+        float total = 0.0f;
+        int k = 0;
+#ifdef FAST_MATH_SSE2
+        if (n >= 4)
+        {
+            __m128 m = _mm_loadu_ps(in);
+            __m128 s = exp_diff4(m, m);   // 每路目前的和为 1 (该路最大值本身)，值为 -inf 的路为 0
+            for (k = 4; k + 4 <= n; k += 4)
+            {
+                __m128 v = _mm_loadu_ps(in + k);
+                if (_mm_movemask_ps(_mm_cmpgt_ps(v, m)))
+                {
+                    __m128 next = _mm_max_ps(m, v);
+                    s = _mm_mul_ps(s, exp_diff4(m, next));
+                    m = next;
+                }
+                s = _mm_add_ps(s, exp_diff4(v, m));
+            }
+            float lane_max[4], lane_sum[4];
+            _mm_storeu_ps(lane_max, m);
+            _mm_storeu_ps(lane_sum, s);
+            max_val = max(max(lane_max[0], lane_max[1]), max(lane_max[2], lane_max[3]));
+            for (int l = 0; l < 4; l++) total += lane_sum[l] * exp_diff(lane_max[l], max_val);
+        }
+#endif
+        for (; k < n; k++) online_update(in[k], max_val, total);
+
+        float inv_total = 1.0f / total;
+        float log_total = std::log(total);
+        k = 0;
+#ifdef FAST_MATH_SSE2
+        __m128 vmax = _mm_set1_ps(max_val);
+        for (; k + 4 <= n; k += 4)
+        {
+            __m128 shifted = _mm_sub_ps(_mm_loadu_ps(in + k), vmax);
+            __m128 result = log ? _mm_sub_ps(shifted, _mm_set1_ps(log_total))
+                                : _mm_mul_ps(fast_math::exp4(shifted), _mm_set1_ps(inv_total));
+            _mm_storeu_ps(out + k, result);
+        }
+#endif
+        for (; k < n; k++) out[k] = finish(in[k], max_val, inv_total, log_total, log);
+    }
+
+    // 跨步的 n 个元素 (softmax 的维度不是最后一维)：相邻的 4 列同时处理，每列是一个独立的 softmax；
+    // 与 softmax_row 一样只在某一列的最大值变大时才缩放已有的和，通常每个元素只算一次 exp
+    void softmax_columns(const float* in, float* out, int n, int inner, bool log)
+    {
+        int i = 0;
+#ifdef FAST_MATH_SSE2
+        for (; i + 4 <= inner; i += 4)
+        {
+            __m128 m = _mm_set1_ps(-numeric_limits<float>::infinity());
+            __m128 s = _mm_setzero_ps();
+            for (int k = 0; k < n; k++)
+            {
+                __m128 v = _mm_loadu_ps(in + k * inner + i);
+                if (_mm_movemask_ps(_mm_cmpgt_ps(v, m)))
+                {
+                    __m128 next = _mm_max_ps(m, v);
+                    s = _mm_mul_ps(s, exp_diff4(m, next));
+                    m = next;
+                }
+                s = _mm_add_ps(s, exp_diff4(v, m));
+            }
+
+            float lane_sum[4];
+            _mm_storeu_ps(lane_sum, s);
+            __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), s);
+            __m128 log_total = _mm_setr_ps(std::log(lane_sum[0]), std::log(lane_sum[1]), std::log(lane_sum[2]), std::log(lane_sum[3]));
+            for (int k = 0; k < n; k++)
+            {
+                __m128 shifted = _mm_sub_ps(_mm_loadu_ps(in + k * inner + i), m);
+                __m128 result = log ? _mm_sub_ps(shifted, log_total) : _mm_mul_ps(fast_math::exp4(shifted), inv);
+                _mm_storeu_ps(out + k * inner + i, result);
+            }
+        }
+#endif
+        for (; i < inner; i++)
+        {
+            float max_val = -numeric_limits<float>::infinity();
+            float total = 0.0f;
+            for (int k = 0; k < n; k++) online_update(in[k * inner + i], max_val, total);
+
+            float inv_total = 1.0f / total;
+            float log_total = std::log(total);
+            for (int k = 0; k < n; k++)
+            {
+                out[k * inner + i] = finish(in[k * inner + i], max_val, inv_total, log_total, log);
+            }
+        }
+    }
+}
+
 vector<int> softMax::get_output_shape(const vector<int>& input_shape)const
 {
     return input_shape;
@@ -14,18 +151,37 @@ vector<int> softMax::get_output_shape(const vector<int>& input_shape)const
 
 void softMax::forward(const Tensor& input, Tensor& output)
 {
-    float max_val = std::max(input.data[0], input.data[1]);
-    output.shape = {input.size()};
+    output.shape = input.shape;
+    output.layout = input.layout;
     output.data.resize(input.size());
+    run(input.shape, input.data.data(), output.data.data());
+}
+
+void softMax::forward_inplace(Tensor& tensor)
+{
+    run(tensor.shape, tensor.data.data(), tensor.data.data());
+}
 
-    float total = 0.0f;
-    for (int i = 0; i < input.data.size(); i++)
+void softMax::run(const vector<int>& shape, const float* in_data, float* out_data) const
+{
+    int dims = static_cast<int>(shape.size());
+    int a = axis < 0 ? axis + dims : axis;
+    if (a < 0 || a >= dims)
     {
-         total += exp(input.data[i] - max_val);
+        throw invalid_argument("softMax forward: axis out of range");
     }
 
-    for (int i = 0; i < input.data.size(); i++)
+    // [outer, n, inner]：n 为做 softmax 的维度，outer 与 inner 都视为批量
+    int outer = 1, inner = 1, n = shape[a];
+    for (int d = 0; d < a; d++) outer *= shape[d];
+    for (int d = a + 1; d < dims; d++) inner *= shape[d];
+    if (n == 0) return;
+
+    for (int o = 0; o < outer; o++)
     {
-        output.data[i] = exp(input.data[i] - max_val) / total;
+        const float* in = in_data + static_cast<size_t>(o) * n * inner;
+        float* out = out_data + static_cast<size_t>(o) * n * inner;
+        if (inner == 1) softmax_row(in, out, n, log);
+        else softmax_columns(in, out, n, inner, log);
     }
-}
\ No newline at end of file
+}
@@ -8,11 +8,25 @@
 #include "layer.h"
 #include "Tensor.h"
 
+// 沿任意一维做 softmax (或 log-softmax)，其余维度视为批量。
+// 每一行先用在线算法一次遍历同时得到最大值与指数和 (遇到更大的值时把已累加的和按 e^(旧最大值 - 新最大值) 缩放)，
+// 再一次遍历写出结果；指数使用 fast_math::exp 的多项式近似 (FastMath.h，相对误差 < 1e-7)，并以 SSE2 每次处理 4 个元素
 class softMax : public layer
 {
+private:
+    int axis = -1;      // 负数表示从最后一维倒数
+    bool log = false;   // true 时输出 log-softmax
+
+    // 按 shape 对 in 做 softmax，结果写入 out (out 可以等于 in)
+    void run(const std::vector<int>& shape, const float* in, float* out) const;
+
 public:
     softMax() = default;
+    explicit softMax(int m_axis, bool m_log = false) : axis(m_axis), log(m_log) {}
     void forward(const Tensor& input, Tensor& output) override;
+    // 每个位置先读后写，输入与输出可以是同一块内存
+    bool supports_inplace() const override { return true; }
+    void forward_inplace(Tensor& tensor) override;
     std::vector<int> get_output_shape(const std::vector<int>& input_shape)const override;
     ~softMax() = default;
 };